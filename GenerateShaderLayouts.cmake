@@ -0,0 +1,172 @@
+# Generates ShaderLayouts.hpp from the GLSL sources of a directory, run in script mode:
+# cmake -DSHADER_DIR=<assets/shaders> -DOUTPUT=<ShaderLayouts.hpp> -P GenerateShaderLayouts.cmake
+#
+# Every shader gets a struct named after its file (text.vert -> shaders::text_vert) with the vertex
+# inputs in attributes (location = declaration order) and the default block uniforms in uniforms.
+# Uniform blocks are skipped, their members are not in the default block. #include files (include/*.glsl)
+# are not parsed, they only hold uniform blocks and functions
+
+if(NOT SHADER_DIR OR NOT OUTPUT)
+    message(FATAL_ERROR "SHADER_DIR and OUTPUT are required")
+endif()
+
+# GLSL type -> GL type enum reported by glGetActiveUniform/glGetActiveAttrib
+set(GLSL_TYPE_float GL_FLOAT)
+set(GLSL_TYPE_vec2 GL_FLOAT_VEC2)
+set(GLSL_TYPE_vec3 GL_FLOAT_VEC3)
+set(GLSL_TYPE_vec4 GL_FLOAT_VEC4)
+set(GLSL_TYPE_int GL_INT)
+set(GLSL_TYPE_ivec2 GL_INT_VEC2)
+set(GLSL_TYPE_ivec3 GL_INT_VEC3)
+set(GLSL_TYPE_ivec4 GL_INT_VEC4)
+set(GLSL_TYPE_uint GL_UNSIGNED_INT)
+set(GLSL_TYPE_bool GL_BOOL)
+set(GLSL_TYPE_mat2 GL_FLOAT_MAT2)
+set(GLSL_TYPE_mat3 GL_FLOAT_MAT3)
+set(GLSL_TYPE_mat4 GL_FLOAT_MAT4)
+set(GLSL_TYPE_sampler2D GL_SAMPLER_2D)
+set(GLSL_TYPE_sampler2DArray GL_SAMPLER_2D_ARRAY)
+set(GLSL_TYPE_samplerCube GL_SAMPLER_CUBE)
+
+# storage type name [size] = initializer, layout and interpolation/precision qualifiers are removed first
+set(DECLARATION "^(in|attribute|uniform)[ \t]+([A-Za-z_][A-Za-z0-9_]*)[ \t]+([A-Za-z_][A-Za-z0-9_]*)[ \t]*(\\[[ \t]*([0-9]+)[ \t]*\\])?[ \t]*(=.*)?$")
+
+file(GLOB SHADER_FILES "${SHADER_DIR}/*.vert" "${SHADER_DIR}/*.frag" "${SHADER_DIR}/*.gs")
+list(SORT SHADER_FILES)
+
+set(STRUCTS "")
+foreach(SHADER_FILE ${SHADER_FILES})
+    get_filename_component(SHADER_NAME "${SHADER_FILE}" NAME)
+    get_filename_component(SHADER_EXTENSION "${SHADER_FILE}" EXT)
+    string(REGEX REPLACE "[^A-Za-z0-9_]" "_" STRUCT_NAME "${SHADER_NAME}")
+
+    file(READ "${SHADER_FILE}" SOURCE)
+
+    # Strip /* */ comments, then // comments and preprocessor lines
+    string(FIND "${SOURCE}" "/*" COMMENT_START)
+    while(NOT COMMENT_START EQUAL -1)
+        string(SUBSTRING "${SOURCE}" 0 ${COMMENT_START} BEFORE)
+        string(SUBSTRING "${SOURCE}" ${COMMENT_START} -1 AFTER)
+        string(FIND "${AFTER}" "*/" COMMENT_END)
+        if(COMMENT_END EQUAL -1)
+            set(AFTER "")
+        else()
+            math(EXPR COMMENT_END "${COMMENT_END} + 2")
+            string(SUBSTRING "${AFTER}" ${COMMENT_END} -1 AFTER)
+        endif()
+        set(SOURCE "${BEFORE} ${AFTER}")
+        string(FIND "${SOURCE}" "/*" COMMENT_START)
+    endwhile()
+    string(REGEX REPLACE "//[^\n]*" "" SOURCE "${SOURCE}")
+    # Preprocessor lines (#version) have no semicolon, they would start the next statement
+    string(REGEX REPLACE "#[^\n]*" "" SOURCE "${SOURCE}")
+
+    # One list element per statement, brackets are escaped so they don't group list elements
+    string(REPLACE "[" "<" SOURCE "${SOURCE}")
+    string(REPLACE "]" ">" SOURCE "${SOURCE}")
+    string(REGEX REPLACE "[\r\n]" " " SOURCE "${SOURCE}")
+    string(REPLACE "{" ";" SOURCE "${SOURCE}")
+    string(REPLACE "}" ";" SOURCE "${SOURCE}")
+
+    set(ATTRIBUTES "")
+    set(ATTRIBUTE_LIST "")
+    set(ATTRIBUTE_COUNT 0)
+    set(UNIFORMS "")
+    set(UNIFORM_LIST "")
+    set(UNIFORM_COUNT 0)
+    foreach(STATEMENT IN LISTS SOURCE)
+        string(REPLACE "<" "[" STATEMENT "${STATEMENT}")
+        string(REPLACE ">" "]" STATEMENT "${STATEMENT}")
+
+        string(REGEX REPLACE "^[ \t]*layout[ \t]*\\([^)]*\\)" "" STATEMENT "${STATEMENT}")
+        string(REGEX REPLACE "(^|[ \t])(flat|smooth|noperspective|lowp|mediump|highp)[ \t]" " " STATEMENT "${STATEMENT}")
+        string(STRIP "${STATEMENT}" STATEMENT)
+
+        # NOTE: "uniform Name {" of a block has no variable name and does not match
+        set(KIND "")
+        if(STATEMENT MATCHES "${DECLARATION}")
+            set(KIND "${CMAKE_MATCH_1}")
+            # Inputs of the other stages are varyings
+            if(NOT KIND STREQUAL "uniform" AND NOT SHADER_EXTENSION STREQUAL ".vert")
+                set(KIND "")
+            endif()
+        endif()
+
+        if(KIND)
+            set(TYPE "${CMAKE_MATCH_2}")
+            set(NAME "${CMAKE_MATCH_3}")
+            set(SIZE 1)
+            if(CMAKE_MATCH_5)
+                set(SIZE "${CMAKE_MATCH_5}")
+            endif()
+
+            if(NOT DEFINED GLSL_TYPE_${TYPE})
+                message(FATAL_ERROR "${SHADER_NAME}: GLSL type ${TYPE} of ${NAME} has no GL type in GenerateShaderLayouts.cmake")
+            endif()
+            set(GL_TYPE "${GLSL_TYPE_${TYPE}}")
+
+            if(NOT KIND STREQUAL "uniform")
+                string(APPEND ATTRIBUTES "        static constexpr ShaderAttribute ${NAME} = { ${ATTRIBUTE_COUNT}, \"${NAME}\", ${GL_TYPE} };\n")
+                list(APPEND ATTRIBUTE_LIST "${NAME}")
+                math(EXPR ATTRIBUTE_COUNT "${ATTRIBUTE_COUNT} + 1")
+            else()
+                string(APPEND UNIFORMS "        static constexpr UniformSlot<${GL_TYPE}> ${NAME} = { ${UNIFORM_COUNT}, \"${NAME}\", ${SIZE} };\n")
+                list(APPEND UNIFORM_LIST "${NAME}")
+                math(EXPR UNIFORM_COUNT "${UNIFORM_COUNT} + 1")
+            endif()
+        endif()
+    endforeach()
+
+    set(ATTRIBUTE_ALL "{}")
+    if(ATTRIBUTE_LIST)
+        string(REPLACE ";" ", " ATTRIBUTE_LIST "${ATTRIBUTE_LIST}")
+        set(ATTRIBUTE_ALL "{ { ${ATTRIBUTE_LIST} } }")
+    endif()
+    set(UNIFORM_ALL "{}")
+    if(UNIFORM_LIST)
+        set(UNIFORM_ALL "")
+        foreach(NAME ${UNIFORM_LIST})
+            list(APPEND UNIFORM_ALL "${NAME}.declaration()")
+        endforeach()
+        string(REPLACE ";" ", " UNIFORM_ALL "${UNIFORM_ALL}")
+        set(UNIFORM_ALL "{ { ${UNIFORM_ALL} } }")
+    endif()
+
+    string(APPEND STRUCTS "// ${SHADER_NAME}\n")
+    string(APPEND STRUCTS "struct ${STRUCT_NAME} {\n")
+    string(APPEND STRUCTS "    struct attributes {\n${ATTRIBUTES}")
+    string(APPEND STRUCTS "        static constexpr std::array<ShaderAttribute, ${ATTRIBUTE_COUNT}> all = ${ATTRIBUTE_ALL};\n")
+    string(APPEND STRUCTS "    };\n")
+    string(APPEND STRUCTS "    struct uniforms {\n${UNIFORMS}")
+    string(APPEND STRUCTS "        static constexpr std::array<ShaderUniform, ${UNIFORM_COUNT}> all = ${UNIFORM_ALL};\n")
+    string(APPEND STRUCTS "    };\n")
+    string(APPEND STRUCTS "};\n\n")
+endforeach()
+
+set(HEADER "// Generated by GenerateShaderLayouts.cmake from the shaders in assets/shaders, do not edit
+#ifndef GRAPHICS_SHADERLAYOUTS_HPP
+#define GRAPHICS_SHADERLAYOUTS_HPP
+
+#include <glad/gl.h>
+//
+
+#include <array>
+
+//
+#include \"ShaderLayout.hpp\"
+
+namespace shaders {
+
+${STRUCTS}}  // namespace shaders
+
+#endif
+")
+
+# Keep the timestamp when nothing changed, sources including the header are not rebuilt
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" PREVIOUS_HEADER)
+    if(PREVIOUS_HEADER STREQUAL HEADER)
+        return()
+    endif()
+endif()
+file(WRITE "${OUTPUT}" "${HEADER}")
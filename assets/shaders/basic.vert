@@ -2,15 +2,14 @@
 
 attribute vec3 position;
 
-uniform mat4 projection;
-uniform mat4 modelView; // view matrix * model matrix
+#include "include/camera.glsl"
 
 void main() {
 
 
     vec4 point_position = vec4( position, 1.0 );
 
-    gl_Position = projection * modelView * point_position;
+    gl_Position = projection * view * point_position;
 }
 
 
@@ -0,0 +1,15 @@
+// Layout position of a glyph corner (y down) in the space of modelView's model matrix
+// BILLBOARD: the text faces the camera, otherwise it lies on the xy plane of the model
+vec3 labelPosition(mat4 modelView, vec2 position) {
+#ifdef BILLBOARD
+    // Quad billboard: Works only on quads that have its center at origin.
+    // http://www.songho.ca/opengl/files/gl_anglestoaxes01.png
+    vec3 right = vec3( modelView[0][0], modelView[1][0], modelView[2][0] ),
+        up = vec3( modelView[0][1], modelView[1][1], modelView[2][1] );
+
+    // Rotate vertex toward camera
+    return (right * position.x) - (up * position.y);
+#else
+    return vec3( position.x, -position.y, 0.0 );
+#endif
+}
@@ -0,0 +1,6 @@
+layout(std140) uniform Camera { // CameraUniformBuffer, shared by every program
+    mat4 view;
+    mat4 projection;
+    mat4 viewInverse;
+    mat4 projectionInverse;
+};
@@ -0,0 +1,24 @@
+// Coverage of a glyph texel from the atlas, the variant matches the font type of the atlas:
+// MSDF multi-channel SDF (FONT_MSDF), BITMAP plain alpha (FONT_DEFAULT, FONT_BITMAP), SDF otherwise (FONT_SDF)
+
+// Anti-aliased edge from the signed distance to the glyph outline
+float sdfAlpha(float distanceFromOutline) {
+    float distanceChangePerFragment = length(vec2(dFdx(distanceFromOutline), dFdy(distanceFromOutline)));
+    return smoothstep(-distanceChangePerFragment, distanceChangePerFragment, distanceFromOutline);
+}
+
+float median(float r, float g, float b) {
+    return max(min(r, g), min(max(r, g), b));
+}
+
+float glyphCoverage(sampler2D atlas, vec2 texCoord) {
+#if defined(MSDF)
+    // NOTE: The median of the three channels rebuilds the sharp corners a single channel rounds off
+    vec3 texel = texture(atlas, texCoord).rgb;
+    return sdfAlpha(median(texel.r, texel.g, texel.b) - 0.5);
+#elif defined(BITMAP)
+    return texture(atlas, texCoord).a;
+#else
+    return sdfAlpha(texture(atlas, texCoord).a - 0.5);
+#endif
+}
@@ -0,0 +1,7 @@
+#version 330
+
+// sdf.frag sampling a multi-channel SDF atlas (FONT_MSDF)
+#ifndef MSDF
+#define MSDF
+#endif
+#include "sdf.frag"
@@ -0,0 +1,10 @@
+#version 330
+
+// sdf.frag with a multi-channel SDF atlas and the label color and opacity of every glyph from the vertex shader
+#ifndef MSDF
+#define MSDF
+#endif
+#ifndef VERTEX_COLOR
+#define VERTEX_COLOR
+#endif
+#include "sdf.frag"
@@ -1,35 +1,41 @@
 #version 330
 
+// Variants (ShaderDefines): MSDF or BITMAP atlas (glyph.glsl), VERTEX_COLOR to multiply the label
+// color by the color of every glyph from the vertex shader (text_instanced.vert, text_batch.vert)
+
 // Input vertex attributes (from vertex shader)
 in vec2 fragTexCoord;
-//in vec4 fragColor;
+#ifdef VERTEX_COLOR
+in vec4 fragColor;      // glyph color and opacity
+#endif
 
 // Input uniform values
 uniform sampler2D texture0;
 
-uniform vec3 fragTextColor = vec3(0.0, 1.0, 0.0);  // Default color is green
+// Label color, programs taking the color from the vertices (TextBatch) leave it white
+#ifdef VERTEX_COLOR
+#define TEXT_COLOR_DEFAULT vec3(1.0)
+#else
+#define TEXT_COLOR_DEFAULT vec3(0.0, 1.0, 0.0)  // Default color is green
+#endif
+uniform vec3 fragTextColor = TEXT_COLOR_DEFAULT;
 uniform float opacity = 1.0;  // Default opacity is 1.0
 
 // Output fragment color
 out vec4 finalColor;
 
-// NOTE: Add here your custom variables
+#include "include/glyph.glsl"
 
 void main()
 {
-    //vec4 textColor = vec4(1.0, 0.0, 0.0, 1.0); // Red color
-
     vec4 diffuseColor = vec4( fragTextColor, opacity );
+#ifdef VERTEX_COLOR
+    diffuseColor *= fragColor;
+#endif
 
     // Texel color fetching from texture sampler
-    // NOTE: Calculate alpha using signed distance field (SDF)
-    float distanceFromOutline = texture(texture0, fragTexCoord).a - 0.5;
-    float distanceChangePerFragment = length(vec2(dFdx(distanceFromOutline), dFdy(distanceFromOutline)));
-    float alpha = smoothstep(-distanceChangePerFragment, distanceChangePerFragment, distanceFromOutline);
+    float alpha = glyphCoverage(texture0, fragTexCoord);
 
     // Calculate final fragment color
     finalColor = vec4(diffuseColor.rgb, diffuseColor.a*alpha);
-    //finalColor = vec4(textColor.rgb, textColor.a*alpha);
-    //vec4 texelColor = texture(texture0, fragTexCoord);
-    //finalColor = texelColor * textColor;
 }
@@ -0,0 +1,24 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+flat in float fragLayer;  // texture array layer of the glyph, exact (flat) so no layer in between is sampled
+in vec4 fragColor;      // label color and opacity
+
+// Input uniform values
+uniform sampler2DArray texture0;
+
+// Output fragment color
+out vec4 finalColor;
+
+#include "include/glyph.glsl"
+
+void main()
+{
+    // Texel color fetching from texture sampler
+    // NOTE: Calculate alpha using signed distance field (SDF)
+    float alpha = sdfAlpha(texture(texture0, vec3(fragTexCoord, fragLayer)).a - 0.5);
+
+    // Calculate final fragment color
+    finalColor = vec4(fragColor.rgb, fragColor.a*alpha);
+}
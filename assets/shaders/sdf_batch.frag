@@ -0,0 +1,7 @@
+#version 330
+
+// sdf.frag with the label color and opacity of every glyph from the vertex shader
+#ifndef VERTEX_COLOR
+#define VERTEX_COLOR
+#endif
+#include "sdf.frag"
@@ -1,7 +1,7 @@
 #version 330
 
 // Input vertex attributes
-in vec3 position;
+in vec2 position; // snorm16, relative to the label origin and divided by positionScale
 in vec2 vertexTexCoord;
 //in vec4 vertexColor;
 
@@ -10,23 +10,21 @@ out vec2 fragTexCoord;
 //out vec4 fragColor;
 
 // Input uniform values
-uniform mat4 projection;
-uniform mat4 modelView; // view matrix * model matrix
+#include "include/camera.glsl"
+uniform mat4 model; // label matrixWorld
+uniform float positionScale = 1.0; // largest layout coordinate of the label
+
+#include "include/billboard.glsl"
 
 void main() {
+    mat4 modelView = view * model;
+
     // Send vertex attributes to fragment shader
     fragTexCoord = vertexTexCoord;
     //fragColor = vertexColor;
 
-    vec3 pos = position;
-    // billboarding
-    // Quad billboard: Works only on quads that have its center at origin.
-    // http://www.songho.ca/opengl/files/gl_anglestoaxes01.png
-    vec3 right = vec3( modelView[0][0], modelView[1][0], modelView[2][0]),
-        up = vec3( modelView[0][1], modelView[1][1], modelView[2][1] );
-
-    // Rotate vertex toward camera
-    pos = (right * pos.x) - (up * pos.y);
+    // Faces the camera with BILLBOARD
+    vec3 pos = labelPosition(modelView, position * positionScale);
 
     vec4 point_position = vec4( pos, 1.0 );
     // Calculate final vertex position
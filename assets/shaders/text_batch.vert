@@ -0,0 +1,31 @@
+#version 330
+
+// Input vertex attributes
+in vec2 position;       // glyph corner relative to the label origin
+in vec2 vertexTexCoord;
+in float vertexLayer;   // texture array layer (sdf_array.frag)
+in vec3 labelOrigin;    // label position in world space
+in vec4 vertexColor;
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+flat out float fragLayer;  // same on every corner of a quad, never interpolated
+out vec4 fragColor;
+
+// Input uniform values
+#include "include/camera.glsl"
+
+#include "include/billboard.glsl"
+
+void main() {
+    // Send vertex attributes to fragment shader
+    fragTexCoord = vertexTexCoord;
+    fragLayer = vertexLayer;
+    fragColor = vertexColor;
+
+    // Faces the camera with BILLBOARD, same as text.vert but around every label origin
+    vec3 pos = labelOrigin + labelPosition(view, position);
+
+    // Calculate final vertex position
+    gl_Position = projection * view * vec4( pos, 1.0 );
+}
@@ -0,0 +1,37 @@
+#version 330
+
+// Input instance attributes, one record per glyph
+in vec4 glyphRect;     // x, y, width, height: snorm16, relative to the label origin and divided by positionScale
+in vec4 glyphTexRect;  // atlas rectangle: u0, v0, u1, v1
+in vec4 glyphColor;
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+out vec4 fragColor;
+
+// Input uniform values
+#include "include/camera.glsl"
+uniform mat4 model; // label matrixWorld
+uniform float positionScale = 1.0; // largest layout coordinate of the label
+
+#include "include/billboard.glsl"
+
+void main() {
+    mat4 modelView = view * model;
+
+    // Unit quad corner from the shared quad index buffer (0,1,2,0,2,3):
+    // 0 top left, 1 bottom left, 2 bottom right, 3 top right
+    vec2 corner = vec2(float(gl_VertexID >= 2), float(gl_VertexID == 1 || gl_VertexID == 2));
+
+    // Send vertex attributes to fragment shader
+    fragTexCoord = mix(glyphTexRect.xy, glyphTexRect.zw, corner);
+    fragColor = glyphColor;
+
+    vec2 position = (glyphRect.xy + corner * glyphRect.zw) * positionScale;
+
+    // Faces the camera with BILLBOARD, same as text.vert
+    vec3 pos = labelPosition(modelView, position);
+
+    // Calculate final vertex position
+    gl_Position = projection * modelView * vec4( pos, 1.0 );
+}
@@ -0,0 +1,50 @@
+#ifndef GRAPHICS_CAMERAUNIFORMBUFFER_HPP
+#define GRAPHICS_CAMERAUNIFORMBUFFER_HPP
+
+#include <glad/gl.h>
+//
+
+//
+#include "cameras/Camera.hpp"
+#include "math/Matrix4.hpp"
+
+// Uniform buffer binding point of the Camera block, reserved for CameraUniformBuffer
+#define CAMERA_UNIFORM_BINDING 0
+// Name of the block in the shaders:
+// layout(std140) uniform Camera { mat4 view; mat4 projection; mat4 viewInverse; mat4 projectionInverse; };
+#define CAMERA_UNIFORM_BLOCK "Camera"
+
+// Process-wide std140 uniform buffer with the matrices of the active camera, read by every program
+// through the Camera block. Programs only need bindBlock() once after linking, camera matrices are
+// never uploaded per program
+struct CameraUniformBuffer {
+    static CameraUniformBuffer& instance();
+
+    CameraUniformBuffer(const CameraUniformBuffer&) = delete;
+    CameraUniformBuffer& operator=(const CameraUniformBuffer&) = delete;
+
+    // Uploads the camera matrices when they differ from the buffer contents, call once per frame
+    // after camera.updateMatrixWorld(). Returns true when the buffer was updated
+    bool update(const graphics::Camera& camera);
+    // Points the Camera block of program to CAMERA_UNIFORM_BINDING, programs without the block are ignored
+    static void bindBlock(GLuint program);
+    // Deletes the GL buffer, call before the context is destroyed
+    void release();
+
+   private:
+    // std140 layout: every mat4 is 4 vec4 columns, no padding between members
+    struct Block {
+        float view[16];
+        float projection[16];
+        float viewInverse[16];
+        float projectionInverse[16];
+    };
+
+    GLuint bufferId = 0;
+    Block block = {};
+    bool uploaded = false;
+
+    CameraUniformBuffer() = default;
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef GRAPHICS_GLDEBUG_HPP
+#define GRAPHICS_GLDEBUG_HPP
+
+#include <glad/gl.h>
+//
+
+// OpenGL diagnostics through the debug output of OpenGL 4.3 / GL_KHR_debug. Messages are reported
+// asynchronously by the driver, so no glGetError() is needed on the hot path. Everything compiles
+// to nothing unless GRAPHICS_GL_DEBUG is defined (Debug builds, or the GRAPHICS_GL_DEBUG CMake option)
+
+// Place of a GL call, kept in static storage by GL_DEBUG_MARK()
+struct GLDebugSite {
+    const char* file;
+    int line;
+    const char* function;
+};
+
+#ifdef GRAPHICS_GL_DEBUG
+// Records the call site of the GL calls that follow, driver messages report the last recorded site
+// NOTE: Messages are asynchronous, the site is the last one marked before the message was delivered
+#define GL_DEBUG_MARK()                                                              \
+    do {                                                                             \
+        static const GLDebugSite glDebugSite_ = { __FILE__, __LINE__, __func__ };    \
+        SetGLDebugSite(&glDebugSite_);                                               \
+    } while (0)
+#else
+#define GL_DEBUG_MARK() ((void)0)
+#endif
+
+// Registers the debug message callback, call once after the GL functions are loaded
+// NOTE: Returns false when GRAPHICS_GL_DEBUG is not defined or the context has no debug output
+bool InstallGLDebugOutput(GLADloadfunc getProcAddress);
+// Runtime switch, the driver stops generating messages while disabled
+void SetGLDebugOutputEnabled(bool enabled);
+void SetGLDebugSite(const GLDebugSite* site);
+
+// True when the context reports the extension in GL_EXTENSIONS (glGetStringi)
+bool HasGLExtension(const char* name);
+
+#endif
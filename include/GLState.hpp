@@ -0,0 +1,98 @@
+#ifndef GRAPHICS_GLSTATE_HPP
+#define GRAPHICS_GLSTATE_HPP
+
+#include <glad/gl.h>
+//
+
+// Texture units shadowed by GLState, bindings on higher units are always issued
+#define GLSTATE_MAX_TEXTURE_UNITS 16
+
+// Calls issued to the driver and calls skipped because the state was already set
+struct GLStateStats {
+    int issuedCalls = 0;
+    int elidedCalls = 0;
+};
+
+// Process-wide shadow of the OpenGL state changed on every draw: capabilities, cull/blend/stencil
+// state, program, vertex array and texture bindings. Setters only reach the driver when the value
+// differs from the shadowed one, so renderers set everything they need and never restore defaults.
+// State starts unknown, the first call of every setter is always issued
+// NOTE: Code calling GL directly on shadowed state (third party libraries) must call invalidate()
+// afterwards, objects deleted while bound must go through the delete functions
+struct GLState {
+    static GLState& instance();
+
+    GLState(const GLState&) = delete;
+    GLState& operator=(const GLState&) = delete;
+
+    // Shadowed: GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_SCISSOR_TEST, GL_STENCIL_TEST
+    void enable(GLenum capability);
+    void disable(GLenum capability);
+    void cullFace(GLenum mode);
+    void frontFace(GLenum mode);
+    void blendFunc(GLenum sfactor, GLenum dfactor);
+    void depthMask(GLboolean flag);
+    void colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+    void stencilMask(GLuint mask);
+    void stencilFunc(GLenum func, GLint ref, GLuint mask);
+    void stencilOp(GLenum sfail, GLenum dpfail, GLenum dppass);
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vertexArray);
+    void activeTexture(GLenum unit);
+    // Binds to the active unit, GL_TEXTURE_2D and GL_TEXTURE_2D_ARRAY are shadowed
+    void bindTexture(GLenum target, GLuint texture);
+
+    // Delete GL objects and clear the bindings pointing to them, names can be reused by glGen*
+    void deleteProgram(GLuint program);
+    void deleteVertexArray(GLuint vertexArray);
+    void deleteTexture(GLuint texture);
+
+    // Forgets every shadowed value, next calls are issued again
+    void invalidate();
+    // Forgets the program, vertex array, active unit and the texture bindings of unit only, for code that
+    // changes nothing else (glText), capabilities and fixed function state stay shadowed
+    void invalidateBindings(GLenum unit = GL_TEXTURE0);
+    // Starts counting calls of a new frame, stats of the finished one are kept in lastFrameStats()
+    void beginFrame();
+    const GLStateStats& frameStats() const;
+    const GLStateStats& lastFrameStats() const;
+
+   private:
+    static const GLuint UNKNOWN = 0xffffffff;
+
+    enum Capability { CAP_BLEND = 0, CAP_CULL_FACE, CAP_DEPTH_TEST, CAP_SCISSOR_TEST, CAP_STENCIL_TEST, CAP_COUNT };
+
+    int capabilities[CAP_COUNT];  // 1 enabled, 0 disabled, -1 unknown
+    GLenum cullMode;
+    GLenum frontMode;
+    GLenum blendSource;
+    GLenum blendDestination;
+    GLuint depthWrite;
+    GLuint colorWrite;  // RGBA bits, UNKNOWN when not known
+    bool stencilWriteKnown;
+    GLuint stencilWrite;
+    GLenum stencilFunction;
+    GLint stencilRef;
+    GLuint stencilFuncMask;
+    GLenum stencilFail;
+    GLenum stencilDepthFail;
+    GLenum stencilPass;
+
+    GLuint program;
+    GLuint vertexArray;
+    GLenum textureUnit;
+    GLuint textures2D[GLSTATE_MAX_TEXTURE_UNITS];
+    GLuint texturesArray[GLSTATE_MAX_TEXTURE_UNITS];
+
+    GLStateStats stats;
+    GLStateStats lastStats;
+
+    GLState();
+
+    void setCapability(GLenum capability, bool enabled);
+    // Counts the call, true when it has to be issued
+    bool changed(bool differs);
+};
+
+#endif
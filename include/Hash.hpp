@@ -0,0 +1,10 @@
+#ifndef GRAPHICS_HASH_HPP
+#define GRAPHICS_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// 64-bit FNV-1a hash, pass the previous result as hash to chain several buffers
+uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL);
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef GRAPHICS_PROGRAMCACHE_HPP
+#define GRAPHICS_PROGRAMCACHE_HPP
+
+#include <glad/gl.h>
+//
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+//
+#include "ShaderPreprocessor.hpp"
+
+// Set to 0 to always link programs from source
+#define PROGRAM_BINARY_CACHE 1
+// Bump whenever the cache file layout changes
+#define PROGRAM_CACHE_VERSION 1
+
+// GL_KHR_parallel_shader_compile / GL_ARB_parallel_shader_compile, not part of the core glad loader
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif
+
+// Called on a new program right before it is linked from source (glBindAttribLocation and similar)
+// NOTE: Must only depend on the shader sources, programs loaded from a binary keep the state of the original link
+using ProgramSetup = std::function<void(GLuint program)>;
+
+// Program whose compile and link were submitted to the driver but not checked yet
+struct ProgramBuild {
+    GLuint program = 0;
+    GLuint vertexShader = 0;  // 0 when loaded from a binary
+    GLuint fragmentShader = 0;
+    std::string cachePath;    // Empty when the binary is not stored
+    uint64_t key = 0;
+};
+
+// Lets the driver compile and link on its own threads, call once after the context is created.
+// Without the extension compiles still start at submit, but may block the first status query
+// Returns false when neither GL_KHR_parallel_shader_compile nor GL_ARB_parallel_shader_compile is available
+bool InstallParallelShaderCompile(GLADloadfunc getProcAddress);
+
+// Builds a program from a vertex and a fragment shader file, both preprocessed (PreprocessShader) with
+// defines to select a variant. The linked binary (glGetProgramBinary) is
+// stored in a "cache" folder next to the vertex shader, keyed by the sources and the driver (vendor,
+// renderer and version strings), later runs load it with glProgramBinary instead of compiling.
+// A binary rejected by the driver falls back to a source compile and is replaced.
+// Without program binary support (OpenGL 4.1 / GL_ARB_get_program_binary) programs are always linked from source
+// NOTE: Throws std::runtime_error when a shader file can't be read or the sources don't compile or link
+GLuint LoadProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const ShaderDefines& defines = {}, const ProgramSetup& beforeLink = nullptr);
+// Compiles and links without touching the cache
+GLuint LinkProgramFromSource(const std::string& vertexGlsl, const std::string& fragmentGlsl, const ProgramSetup& beforeLink = nullptr);
+
+// LoadProgram() in two steps: SubmitProgram() issues the compile and link without querying any status,
+// so the driver can build many programs at once, FinishProgram() checks the result and stores the binary.
+// Submit every program first, then finish them once IsProgramBuildComplete() returns true
+// NOTE: Only file read and #include errors throw at submit, compile and link errors throw from FinishProgram()
+ProgramBuild SubmitProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const ShaderDefines& defines = {}, const ProgramSetup& beforeLink = nullptr);
+// Never blocks with parallel compile, true without it (the first status query waits instead)
+bool IsProgramBuildComplete(const ProgramBuild& build);
+// Waits for the build when it is not complete, returns the linked program. The shaders are deleted
+// NOTE: A program that failed is not deleted, the caller still owns build.program
+GLuint FinishProgram(ProgramBuild& build);
+
+#endif
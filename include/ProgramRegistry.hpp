@@ -0,0 +1,66 @@
+#ifndef GRAPHICS_PROGRAMREGISTRY_HPP
+#define GRAPHICS_PROGRAMREGISTRY_HPP
+
+#include <glad/gl.h>
+//
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+//
+#include "ProgramCache.hpp"
+#include "UniformHandle.hpp"
+
+// Process-wide reference counted programs, one per preprocessed vertex/fragment source pair and define set
+// (variant). Labels and shaders built from the same sources share a single GL program instead of compiling
+// and linking their own copy, whatever path reached the files.
+// Uniform values belong to the program, users of a shared program set their own values before drawing
+// (the shadows in uniforms() skip the ones already uploaded).
+// Programs are only submitted by acquire(), their status is checked lazily by ready() so every
+// program created at startup compiles at once (in parallel with GL_KHR_parallel_shader_compile)
+struct ProgramRegistry {
+    static ProgramRegistry& instance();
+
+    ProgramRegistry(const ProgramRegistry&) = delete;
+    ProgramRegistry& operator=(const ProgramRegistry&) = delete;
+
+    // Program for the variant of the shader pair, submitted (SubmitProgram) on the first acquire.
+    // beforeLink only runs for that first acquire, every user of a variant must pass the same setup
+    // NOTE: The program can't be queried or drawn before ready() returns true
+    GLuint acquire(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const ShaderDefines& defines = {}, const ProgramSetup& beforeLink = nullptr);
+    // True once program is linked (Camera block bound), never waits for the driver with parallel compile.
+    // Draws skip programs that are not ready
+    // NOTE: Never throws, a program that failed to compile or link is logged once and stays not ready
+    bool ready(GLuint program);
+    // Blocks until program is linked, for users that reflect the program right away.
+    // NOTE: Throws std::runtime_error when the program failed to compile or link
+    void wait(GLuint program);
+    // Drops a reference, the program is deleted with the last one
+    void release(GLuint program);
+    // Uniforms of program shared by all its users, empty until one of them fills it
+    // NOTE: Copies of the UniformInfo entries share the shadow values, throws std::runtime_error for a program
+    // that is not in the registry (never acquired or already released)
+    std::unordered_map<std::string, UniformInfo>& uniforms(GLuint program);
+    // Number of programs alive
+    size_t size() const { return programs.size(); }
+
+   private:
+    struct Entry {
+        uint64_t key = 0;
+        int references = 0;
+        bool linked = false;
+        bool failed = false;  // Compile or link error, reported once
+        ProgramBuild build;  // Pending compile and link until linked
+        std::unordered_map<std::string, UniformInfo> uniforms;
+    };
+
+    std::unordered_map<uint64_t, GLuint> programIds;  // Hash of the sources and defines -> program
+    std::unordered_map<GLuint, Entry> programs;
+
+    ProgramRegistry() = default;
+
+    void finish(GLuint program, Entry& entry);
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef GRAPHICS_QUADINDEXBUFFER_HPP
+#define GRAPHICS_QUADINDEXBUFFER_HPP
+
+#include <glad/gl.h>
+//
+
+#include <cstddef>
+
+// Largest quad count addressable with 16-bit indices (4 vertices per quad)
+#define QUAD_INDEX_MAX_16BIT_QUADS 16384
+
+// Process-wide element buffer with the 0,1,2,0,2,3 pattern of every quad, vertex 4*k is the first
+// corner of quad k. It is grown on demand and shared by all text and sprite batches.
+// Indices are 16-bit until a batch needs more than QUAD_INDEX_MAX_16BIT_QUADS quads
+// NOTE: The buffer keeps its GL name when it grows, VAOs that bound it stay valid
+// but must query indexType() at draw time
+struct QuadIndexBuffer {
+    static QuadIndexBuffer& instance();
+
+    QuadIndexBuffer(const QuadIndexBuffer&) = delete;
+    QuadIndexBuffer& operator=(const QuadIndexBuffer&) = delete;
+
+    // Binds the buffer to GL_ELEMENT_ARRAY_BUFFER of the current VAO, growing it to cover quads
+    void bind(size_t quads);
+    // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    GLenum indexType() const;
+    // Byte offset of the first index of quad, for glDrawElements
+    const void* quadOffset(size_t quad) const;
+    size_t quadCapacity() const;
+    // Deletes the GL buffer, call before the context is destroyed
+    void release();
+
+   private:
+    GLuint bufferId = 0;
+    size_t capacity = 0;
+    bool wideIndices = false;
+
+    QuadIndexBuffer() = default;
+
+    void grow(size_t quads);
+};
+
+#endif
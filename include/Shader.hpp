@@ -10,6 +10,7 @@
 #include <utility>
 
 //
+#include "UniformHandle.hpp"
 #include "math/Color.hpp"
 #include "math/Matrix3.hpp"
 #include "math/Matrix4.hpp"
@@ -23,13 +24,6 @@ struct Buffer {
     unsigned int version{};
 };
 
-struct UniformInfo {
-    GLenum type;
-    std::string name;
-    GLint size;
-    GLint location;
-};
-
 struct Shader {
     Shader(const std::string& vertexShaderPath, const std::string& fragmentShaderPath);
     std::string ReadShaderFile(const std::string& filePath) const;
@@ -42,11 +36,17 @@ struct Shader {
     std::unordered_map<std::string, int> getAttributes();
     std::unordered_map<std::string, UniformInfo> getUniforms();
 
-    // set uniform functions
+    // Typed handle resolved once, use it for uniforms set every frame
+    template <typename T>
+    UniformHandle<T> uniform(const std::string& uniformName) const {
+        return FindUniform<T>(program, uniformMap, uniformName);
+    }
+
+    // set uniform functions, values equal to the last uploaded one are skipped
     void set_glUniform1f(const std::string& uniformName, const float& newValue);
     void set_glUniform3f(const std::string& uniformName, const Color& newValue);
     void set_glUniformMatrix3fv(const std::string& uniformName, const Matrix3& newValue);
-    void set_glUniformMatrix4fv(const std::string& uniformName, const Matrix4 newValue);
+    void set_glUniformMatrix4fv(const std::string& uniformName, const Matrix4& newValue);
 
     // render functions
     void Use() const;
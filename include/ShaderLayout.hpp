@@ -0,0 +1,76 @@
+#ifndef GRAPHICS_SHADERLAYOUT_HPP
+#define GRAPHICS_SHADERLAYOUT_HPP
+
+#include <glad/gl.h>
+//
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+//
+#include "UniformHandle.hpp"
+
+// Declarations of the shaders in assets/shaders, generated at build time into ShaderLayouts.hpp
+// (see GenerateShaderLayouts.cmake). Programs bind the attribute locations before linking and
+// address uniforms through typed slots, a misspelled name or a wrong C++ type is a compile error
+
+// Vertex input, location is the declaration order in the shader
+struct ShaderAttribute {
+    GLuint location;
+    const char* name;
+    GLenum type;
+};
+
+struct ShaderUniform {
+    int slot;  // Declaration order in the shader
+    const char* name;
+    GLint size;
+    GLenum type;
+};
+
+template <GLenum GLType>
+struct UniformSlot {
+    int slot;
+    const char* name;
+    GLint size;
+
+    constexpr ShaderUniform declaration() const { return { slot, name, size, GLType }; }
+};
+
+// Binds the generated locations of the vertex inputs of Layout, call before glLinkProgram
+template <typename Layout>
+void BindAttributeLocations(GLuint program) {
+    for (const ShaderAttribute& attribute : Layout::attributes::all) glBindAttribLocation(program, attribute.location, attribute.name);
+}
+
+// Adds the uniforms of Layout to uniforms, call after linking for every stage of the program
+// NOTE: Explicit uniform locations need OpenGL 4.3, locations are queried once by name instead
+template <typename Layout>
+void AddUniforms(GLuint program, std::unordered_map<std::string, UniformInfo>& uniforms) {
+    for (const ShaderUniform& uniform : Layout::uniforms::all) {
+        if (uniforms.find(uniform.name) != uniforms.end()) continue;  // Declared by another stage
+
+        UniformInfo info;
+        info.type = uniform.type;
+        info.name = uniform.name;
+        info.size = uniform.size;
+        info.location = glGetUniformLocation(program, uniform.name);
+        info.shadow = std::make_shared<UniformShadow>();
+
+        uniforms[info.name] = info;
+    }
+}
+
+// Handle of a generated uniform slot, invalid when the linker optimized the uniform out
+template <typename T, GLenum GLType>
+UniformHandle<T> FindUniform(GLuint program, const std::unordered_map<std::string, UniformInfo>& uniforms, const UniformSlot<GLType>& slot) {
+    static_assert(UniformTraits<T>::glType == GLType, "C++ type does not match the GLSL type of the uniform");
+
+    auto it = uniforms.find(slot.name);
+    if ((it == uniforms.end()) || (it->second.location == -1)) return UniformHandle<T>();
+
+    return UniformHandle<T>(program, it->second);
+}
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef GRAPHICS_SHADERPREPROCESSOR_HPP
+#define GRAPHICS_SHADERPREPROCESSOR_HPP
+
+#include <map>
+#include <string>
+
+// Preprocessor symbols of a shader variant, name -> value ("" for a plain #define NAME)
+// NOTE: Ordered, equal sets always give the same key
+using ShaderDefines = std::map<std::string, std::string>;
+
+// "NAME=value;" for every define, part of the program and variant keys
+std::string ShaderDefinesKey(const ShaderDefines& defines);
+
+// Source of a variant of the shader file: every #include "file" is replaced by the contents of the file
+// (relative to the including one, each file is only included once) and defines are inserted after
+// the #version line. #version lines of included files are skipped, so a shader can include another one
+// and specialize it with its own #define. Compile errors keep their line numbers through #line
+// directives, source string 0 is the shader file and 1.. the includes in the order they are first met.
+// Variants are cached by path and defines, the files are read once
+// NOTE: Throws std::runtime_error when a file can't be read or an #include is malformed or recursive
+const std::string& PreprocessShader(const std::string& filePath, const ShaderDefines& defines = {});
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef GRAPHICS_UNIFORMHANDLE_HPP
+#define GRAPHICS_UNIFORMHANDLE_HPP
+
+#include <glad/gl.h>
+//
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+//
+#include "GLDebug.hpp"
+#include "GLState.hpp"
+#include "math/Color.hpp"
+#include "math/Matrix3.hpp"
+#include "math/Matrix4.hpp"
+#include "math/Vector3.hpp"
+
+// Last value uploaded to a uniform, shared by every handle and setter of the same program uniform
+// NOTE: Large enough for a mat4, the biggest type supported by UniformHandle
+struct UniformShadow {
+    float values[16] = { 0 };
+    bool known = false;  // Nothing uploaded yet, GLSL initializers are not read back
+};
+
+struct UniformInfo {
+    GLenum type;
+    std::string name;
+    GLint size;
+    GLint location;
+    std::shared_ptr<UniformShadow> shadow;
+};
+
+// Upload function and GL type of every supported uniform type
+template <typename T>
+struct UniformTraits;
+
+template <>
+struct UniformTraits<float> {
+    static const GLenum glType = GL_FLOAT;
+    static const int count = 1;
+    static void pack(const float& value, float* out) { out[0] = value; }
+    static void upload(GLint location, const float* values) { glUniform1f(location, values[0]); }
+};
+
+template <>
+struct UniformTraits<graphics::Color> {
+    static const GLenum glType = GL_FLOAT_VEC3;
+    static const int count = 3;
+    static void pack(const graphics::Color& value, float* out) {
+        out[0] = value.r;
+        out[1] = value.g;
+        out[2] = value.b;
+    }
+    static void upload(GLint location, const float* values) { glUniform3fv(location, 1, values); }
+};
+
+template <>
+struct UniformTraits<graphics::Vector3> {
+    static const GLenum glType = GL_FLOAT_VEC3;
+    static const int count = 3;
+    static void pack(const graphics::Vector3& value, float* out) {
+        out[0] = value.x;
+        out[1] = value.y;
+        out[2] = value.z;
+    }
+    static void upload(GLint location, const float* values) { glUniform3fv(location, 1, values); }
+};
+
+template <>
+struct UniformTraits<graphics::Matrix3> {
+    static const GLenum glType = GL_FLOAT_MAT3;
+    static const int count = 9;
+    static void pack(const graphics::Matrix3& value, float* out) { std::copy(value.elements.begin(), value.elements.end(), out); }
+    static void upload(GLint location, const float* values) { glUniformMatrix3fv(location, 1, false, values); }
+};
+
+template <>
+struct UniformTraits<graphics::Matrix4> {
+    static const GLenum glType = GL_FLOAT_MAT4;
+    static const int count = 16;
+    static void pack(const graphics::Matrix4& value, float* out) { std::copy(value.elements.begin(), value.elements.end(), out); }
+    static void upload(GLint location, const float* values) { glUniformMatrix4fv(location, 1, false, values); }
+};
+
+// Uniform location resolved once from the program uniforms, set() compares with the shadowed value
+// and only makes the program current and uploads when it changed. Default constructed handles (and
+// handles of uniforms optimized out by the linker) are invalid and ignore set()
+// NOTE: Handles stay valid while the program that created them is alive
+template <typename T>
+struct UniformHandle {
+    UniformHandle() = default;
+    UniformHandle(GLuint program, const UniformInfo& info) : program(program), location(info.location), shadow(info.shadow) {}
+
+    bool valid() const { return (location != -1) && (shadow != nullptr); }
+
+    void set(const T& value) {
+        if (!valid()) return;
+
+        float values[UniformTraits<T>::count];
+        UniformTraits<T>::pack(value, values);
+        if (shadow->known && std::equal(values, values + UniformTraits<T>::count, shadow->values)) return;
+
+        std::copy(values, values + UniformTraits<T>::count, shadow->values);
+        shadow->known = true;
+
+        GLState::instance().useProgram(program);
+        GL_DEBUG_MARK();
+        UniformTraits<T>::upload(location, values);
+    }
+
+   private:
+    GLuint program = 0;
+    GLint location = -1;
+    std::shared_ptr<UniformShadow> shadow;
+};
+
+// Resolves a handle from the uniforms of a program, invalid when missing or declared with another type
+template <typename T>
+UniformHandle<T> FindUniform(GLuint program, const std::unordered_map<std::string, UniformInfo>& uniforms, const std::string& uniformName) {
+    auto it = uniforms.find(uniformName);
+
+    if (it == uniforms.end()) {
+        std::cout << "Uniform '" << uniformName << "' not found in the map." << std::endl;
+        return UniformHandle<T>();
+    }
+    if (it->second.type != UniformTraits<T>::glType) {
+        std::cerr << "Uniform '" << uniformName << "' is declared with GL type " << it->second.type << ", expected " << UniformTraits<T>::glType << std::endl;
+        return UniformHandle<T>();
+    }
+
+    return UniformHandle<T>(program, it->second);
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef GRAPHICS_LABEL_FONTCACHE_HPP
+#define GRAPHICS_LABEL_FONTCACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+#include "Label/helpers.hpp"
+#include "MappedFile.hpp"
+
+// Bump whenever the cache file layout or the glyph generation output changes
+#define FONT_CACHE_VERSION 4
+
+// Everything the generated atlas depends on, a mismatch on any field invalidates the cache
+struct FontCacheKey {
+    uint64_t fileHash = 0;     // Hash of the TTF file contents
+    int baseSize = 0;          // Font size used to generate the glyphs
+    int fontType = 0;          // FontType used on LoadFontData
+    int sdfPadding = 0;        // FONT_SDF_CHAR_PADDING
+    int sdfOnEdgeValue = 0;    // FONT_SDF_ON_EDGE_VALUE
+    float sdfDistScale = 0;    // FONT_SDF_PIXEL_DIST_SCALE
+    int sdfSupersample = 0;    // FONT_SDF_SUPERSAMPLE
+    int fontEngine = 0;        // 1 when glyphs are rasterized by FreeType (GRAPHICS_FREETYPE)
+    int atlasCompression = 0;  // FONT_ATLAS_COMPRESSION
+    int glyphPadding = 0;      // Padding between glyphs in the atlas
+    int packMethod = 0;        // GenImageFontAtlas pack method
+    std::vector<int> codepoints;
+
+    uint64_t hash() const;
+};
+
+// Memory-mapped font atlas cache file, pixel data is read straight from the mapping
+struct FontCacheFile {
+    // Maps the cache file and checks it was generated with the same key
+    bool open(const std::string& cachePath, const FontCacheKey& key);
+    void close();
+
+    int glyphCount() const;
+    // Copies glyph metrics and atlas rectangles into newly allocated arrays (images are left empty)
+    void loadGlyphs(GlyphInfo** glyphs, Rectangle** recs) const;
+    // Atlas image pointing into the mapped file, valid until close()
+    Image atlasImage() const;
+
+   private:
+    MappedFile file_;
+};
+
+FontCacheKey MakeFontCacheKey(const unsigned char* fileData, int dataSize, int fontSize, int type, const int* codepoints, int codepointCount, int glyphPadding, int packMethod);
+// Cache files live next to the font, inside a "cache" folder
+std::string GetFontCachePath(const std::string& fontPath, const FontCacheKey& key);
+bool SaveFontCache(const std::string& cachePath, const FontCacheKey& key, const GlyphInfo* glyphs, const Rectangle* recs, int glyphCount, Image atlas);
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef GRAPHICS_LABEL_FREETYPEFONT_HPP
+#define GRAPHICS_LABEL_FREETYPEFONT_HPP
+
+#include <list>
+#include <vector>
+
+//
+#include "Label/helpers.hpp"
+
+// Limits of the FreeType cache manager, shared by every font
+#ifndef FREETYPE_CACHE_MAX_FACES
+#define FREETYPE_CACHE_MAX_FACES 8  // Open faces, least recently used ones are closed and reopened on demand
+#endif
+#ifndef FREETYPE_CACHE_MAX_SIZES
+#define FREETYPE_CACHE_MAX_SIZES 16  // Face size objects (one per face and font size)
+#endif
+#ifndef FREETYPE_CACHE_MAX_BYTES
+#define FREETYPE_CACHE_MAX_BYTES (4 * 1024 * 1024)  // Rendered glyph bitmaps kept by the small bitmap cache
+#endif
+
+struct FT_LibraryRec_;
+struct FTC_ManagerRec_;
+struct FTC_SBitCacheRec_;
+
+// Glyph rasterizer built on FreeType (GRAPHICS_FREETYPE builds), replaces stb_truetype on LoadFontData().
+// Rendered glyphs go to a FTC_SBitCache bounded by FREETYPE_CACHE_MAX_BYTES across all fonts, so glyphs
+// evicted from a GlyphAtlas and loaded again are not rasterized twice. FONT_SDF glyphs use the FreeType
+// sdf renderer, with the same padding and FONT_SDF_ON_EDGE_VALUE/FONT_SDF_PIXEL_DIST_SCALE encoding
+// NOTE: Not thread safe, glyphs are generated on the calling thread
+struct FreeTypeFontEngine {
+    static FreeTypeFontEngine& instance();
+
+    FreeTypeFontEngine(const FreeTypeFontEngine&) = delete;
+    FreeTypeFontEngine& operator=(const FreeTypeFontEngine&) = delete;
+    ~FreeTypeFontEngine();
+
+    // Same output as the stb_truetype path of LoadFontData(): metrics and GRAYSCALE images of every codepoint
+    // NOTE: fileData is copied the first time it is seen, the caller can free it afterwards
+    GlyphInfo* loadFontData(const unsigned char* fileData, int dataSize, int fontSize, const int* codepoints, int codepointCount, int type);
+
+   private:
+    FT_LibraryRec_* library = nullptr;
+    FTC_ManagerRec_* manager = nullptr;
+    FTC_SBitCacheRec_* sbitCache = nullptr;
+    std::list<std::vector<unsigned char>> faces;  // Font files known by the cache manager, their address is the FTC_FaceID
+
+    FreeTypeFontEngine();
+
+    void* getFaceId(const unsigned char* fileData, int dataSize);
+};
+
+#endif
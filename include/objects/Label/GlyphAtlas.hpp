@@ -0,0 +1,93 @@
+#ifndef GRAPHICS_LABEL_GLYPHATLAS_HPP
+#define GRAPHICS_LABEL_GLYPHATLAS_HPP
+
+#include <glad/gl.h>
+//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+//
+#include "Label/GlyphIndexTable.hpp"
+#include "Label/TextLayout.hpp"
+#include "Label/helpers.hpp"
+#include "stb_rect_pack.h"
+
+namespace graphics {
+
+// Glyph atlas filled on demand: codepoints are rasterized the first time they are requested
+// and packed incrementally with the stb_rect_pack skyline packer. When the texture is full
+// the least recently used glyphs are evicted and the remaining ones are packed again.
+// NOTE: font.glyphs/font.recs are allocated once with maxGlyphs slots and never reallocated,
+// so a copy of the Font struct stays valid, slot 0 is reserved for the '?' fallback glyph
+// (left empty when the font has no '?')
+struct GlyphAtlas {
+    Font font = { 0 };
+    // Incremented every time glyphs are moved or evicted, cached texture coordinates must be rebuilt
+    unsigned int generation = 0;
+    // Kerning grows with the glyphs added to the atlas, layouts are shared by every label using it
+    std::shared_ptr<TextLayoutCache> layoutCache;
+
+    GlyphAtlas(const std::string& fontPath, int fontSize, int fontType, int width, int height, int maxGlyphs);
+    ~GlyphAtlas();
+
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    // Slot of codepoint in font.glyphs/font.recs, it is rasterized and packed when missing
+    // NOTE: In case a codepoint is not available in the font or can't be packed, slot of '?' is returned
+    int getGlyphIndex(int codepoint);
+    // Marks glyphs as used on the current frame
+    void touch(const std::vector<int>& slots);
+    // Starts a new frame, glyphs used on the current frame are never evicted
+    void beginFrame();
+    // Uploads the area modified since the last flush with glTexSubImage2D
+    void flush();
+    // FontType the glyphs are rasterized with, labels pick the matching shader variant
+    int getFontType() const { return fontType; }
+
+   private:
+    struct Slot {
+        int codepoint = -1;  // -1 when the slot is free
+        unsigned int lastUsed = 0;
+    };
+
+    unsigned char* fileData = nullptr;
+    int fileSize = 0;
+    KerningSource* kerningSource = nullptr;  // Pairs of every codepoint added so far, never rescans the atlas
+    int fontType = FONT_SDF;
+    int padding = 1;   // Empty pixels around every glyph, avoids bleeding with bilinear filtering
+    int channels = 1;  // Bytes per pixel, 3 for FONT_MSDF glyphs
+
+    std::vector<unsigned char> pixels;  // CPU copy of the atlas (channels bytes per pixel)
+    std::vector<Slot> glyphSlots;
+    std::vector<int> freeSlots;
+    GlyphIndexTable codepointSlots;  // codepoint -> slot, missing glyphs map to the fallback slot
+    unsigned int frame = 1;
+
+    // NOTE: stbrp_context points into packNodes and to itself, both are swapped as a whole on repacking
+    std::unique_ptr<stbrp_context> packContext;
+    std::vector<stbrp_node> packNodes;
+
+    // Area modified since the last flush, empty when dirtyMinX >= dirtyMaxX
+    int dirtyMinX = 0;
+    int dirtyMinY = 0;
+    int dirtyMaxX = 0;
+    int dirtyMaxY = 0;
+
+    int insertGlyph(int codepoint);
+    // Fills slot with a glyph already packed into the atlas
+    void storeGlyph(int slot, int codepoint, const GlyphInfo& glyph);
+    int acquireSlot();
+    bool packGlyph(int slot, const GlyphInfo& glyph);
+    bool evictAndRepack(int slot, const GlyphInfo& glyph);
+    void copyGlyphPixels(const GlyphInfo& glyph, int x, int y);
+    void markDirty(int x, int y, int width, int height);
+    void releaseSlot(int slot);
+    void addKerning(int codepoint);
+};
+
+}  // namespace graphics
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef GRAPHICS_LABEL_GLYPHINDEXTABLE_HPP
+#define GRAPHICS_LABEL_GLYPHINDEXTABLE_HPP
+
+#include <cstdint>
+#include <vector>
+
+//
+#include "Label/helpers.hpp"
+
+// Codepoints below this value are looked up in a direct table (Latin, Greek, Cyrillic, Hebrew, Arabic)
+#define GLYPH_INDEX_DIRECT_RANGE 0x800
+
+// Constant time codepoint -> glyph index lookup, replaces the linear scan of GetGlyphIndex()
+// in the layout loops. Low codepoints index a flat array, sparse ones (CJK, symbols, emoji)
+// go to an open addressing hash table with linear probing
+struct GlyphIndexTable {
+    // Rebuilds the table from font.glyphs, '?' becomes the fallback index
+    void build(const Font& font);
+    void clear();
+
+    // Glyph index of codepoint, -1 when missing
+    int find(int codepoint) const;
+    // Glyph index of codepoint, fallback index when missing (same result as GetGlyphIndex())
+    int get(int codepoint) const;
+
+    void set(int codepoint, int index);
+    void erase(int codepoint);
+
+    int fallbackIndex = 0;
+
+   private:
+    struct Entry {
+        int codepoint;  // EMPTY_KEY or TOMBSTONE_KEY when not used
+        int index;
+    };
+
+    static const int EMPTY_KEY = -1;
+    static const int TOMBSTONE_KEY = -2;
+
+    std::vector<int> direct;  // Sized up to the highest low codepoint present, -1 when missing
+    std::vector<Entry> entries;
+    size_t used = 0;  // Entries holding a codepoint or a tombstone
+
+    size_t findSlot(int codepoint) const;
+    void rehash(size_t capacity);
+};
+
+#endif
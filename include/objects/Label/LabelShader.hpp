@@ -4,22 +4,50 @@
 #include <glad/gl.h>
 //
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 
 //
+#include "Label/GlyphAtlas.hpp"
+#include "Label/GlyphIndexTable.hpp"
+#include "Label/TextLayout.hpp"
 #include "Label/helpers.hpp"
 #include "Shader.hpp"
+#include "ShaderLayout.hpp"
+#include "ShaderPreprocessor.hpp"
 #include "math/Color.hpp"
 #include "math/Matrix3.hpp"
 #include "math/Matrix4.hpp"
 #include "math/Vector2.hpp"
 #include "objects/Object3D.hpp"
 
+// Changed quads closer than this are uploaded with a single glBufferSubData
+#define LABEL_UPLOAD_MERGE_GAP 4
+
 namespace graphics {
 
+// How glyph quads reach the GPU
+typedef enum {
+    LABEL_RENDER_VERTICES = 0,  // 4 vertices per glyph (8 with backface) built on the CPU, text.vert
+    LABEL_RENDER_INSTANCED      // One GlyphInstance per glyph expanded by instancing, text_instanced.vert + sdf.frag (VERTEX_COLOR)
+} LabelRenderMode;
+
+// Interleaved text vertex, 8 bytes instead of 5 floats in two buffers
+struct TextVertex {
+    int16_t x, y;   // snorm16 position relative to the label origin, scaled by positionScale
+    uint16_t u, v;  // unorm16 texture coordinates
+};
+
+// Glyph record for LABEL_RENDER_INSTANCED, 20 bytes instead of 4 or 8 vertices
+struct GlyphInstance {
+    int16_t x, y, width, height;  // snorm16 glyph rectangle relative to the label origin, scaled by positionScale
+    uint16_t u0, v0, u1, v1;      // unorm16 atlas rectangle
+    uint8_t r, g, b, a;           // per glyph color, multiplied by the tint and opacity uniforms (white for plain labels)
+};
+
 struct LabelShader : public Object3D {
     float opacity = 1.0;
     int textLineSpacing = 15;
@@ -30,24 +58,49 @@ struct LabelShader : public Object3D {
     float spacing = 0.0f;
     float lineSpace = 10.0f;  // space between lines after using \n on text
     Color tint = { 0.0f, 1.0f, 1.0f };
+    // Shared atlas filled on demand, when set glyphs come from it instead of the fixed font atlas
+    // NOTE: Labels always sample a 2D atlas (sampler2D), a TextureArrayAtlas is only drawn by TextBatch
+    std::shared_ptr<GlyphAtlas> glyphAtlas;
+    // Kerning and cached layouts of the font, labels using the same font can share it
+    std::shared_ptr<TextLayoutCache> layoutCache;
 
-    LabelShader(const char* labelName, const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const std::string& fontPath, const Color& textColor);
+    // fontType selects the sdf.frag variant: FONT_SDF, FONT_MSDF (MSDF) or FONT_DEFAULT/FONT_BITMAP (BITMAP)
+    LabelShader(const char* labelName, const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const std::string& fontPath, const Color& textColor,
+                LabelRenderMode mode = LABEL_RENDER_VERTICES, int fontType = FONT_SDF);
+    LabelShader(const char* labelName, const std::string& vertexShaderPath, const std::string& fragmentShaderPath, std::shared_ptr<GlyphAtlas> atlas, const Color& textColor,
+                LabelRenderMode mode = LABEL_RENDER_VERTICES);
     std::string ReadShaderFile(const std::string& filePath) const;
     void createProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath);
+    // Defines of the shader variant (BILLBOARD, MSDF/BITMAP, VERTEX_COLOR) matching the label settings
+    ShaderDefines shaderDefines() const;
+    // Text faces the camera (default) or lies on the xy plane of the label, switches to the other program variant
+    void setBillboard(bool enabled);
     // Convert image data to OpenGL texture (returns OpenGL valid Id)
     unsigned int loadTexture(const void* data, int width, int height, int format, int mipmapCount);
     Texture LoadTextureFromImage(Image image);
-    void init_font(const std::string& fontPath);
+    void init_font(const std::string& fontPath, int fontType = FONT_SDF);
     Vector2 MeasureTextEx(const char* text, float fontSize, float spacing);
 
-    std::unordered_map<std::string, int> getAttributes();
+    // Uniforms declared by the label shaders (generated ShaderLayouts.hpp) with their locations
+    // NOTE: Empty until the program is linked, see programReady()
     std::unordered_map<std::string, UniformInfo> getUniforms();
 
-    // set uniform functions
+    // Typed handle resolved once, use it for uniforms set every frame
+    template <typename T>
+    UniformHandle<T> uniform(const std::string& uniformName) const {
+        return FindUniform<T>(program, uniformMap, uniformName);
+    }
+    // Same from a generated slot (shaders::text_vert::uniforms::model), T is checked at compile time
+    template <typename T, GLenum GLType>
+    UniformHandle<T> uniform(const UniformSlot<GLType>& slot) const {
+        return FindUniform<T>(program, uniformMap, slot);
+    }
+
+    // set uniform functions, values equal to the last uploaded one are skipped
     void set_glUniform1f(const std::string& uniformName, const float& newValue);
     void set_shader_text_color(const Color& newColor);
     void set_glUniformMatrix3fv(const std::string& uniformName, const Matrix3& newValue);
-    void set_glUniformMatrix4fv(const std::string& uniformName, const Matrix4 newValue);
+    void set_glUniformMatrix4fv(const std::string& uniformName, const Matrix4& newValue);
 
     // vertex building functions
     void DrawTexturePro(Rectangle source, Rectangle dest, Vector2 origin, float rotation);
@@ -58,10 +111,17 @@ struct LabelShader : public Object3D {
     // NOTE: chars spacing is NOT proportional to fontSize
     void DrawTextEx(Vector3 position);
     void DrawTexture(int posX, int posY, float rotation, float scale);
-    void buildIndexBufferData();
     void buildVertices(Vector3 fontPosition);
+    void packVertices();
+    void packInstances();
+    // Builds vertices again and uploads the quads that changed to the existing buffers
+    void rebuildVertices();
+    // Text is copied, only the glyphs that differ from the current text are uploaded
+    void setText(const std::string& text);
+    void setStyle(float newFontSize, float newSpacing, float newLineSpace);
     // buffer functions
     void createTextBuffer(GLenum usage);
+    void uploadRecords(const void* data, size_t count, const void* previous, size_t previousCount, size_t recordSize);
 
     // render functions
     void Use() const;
@@ -71,20 +131,45 @@ struct LabelShader : public Object3D {
 
    private:
     std::unordered_map<std::string, UniformInfo> uniformMap;
-    std::unordered_map<std::string, int> cachedAttributes;
+    UniformHandle<float> positionScaleUniform;
+    UniformHandle<Matrix4> modelUniform;  // matrixWorld, uploaded by render() when it changed
+    UniformHandle<Color> textColorUniform;  // tint, label wide in every render mode
+    UniformHandle<float> opacityUniform;
     std::unordered_map<std::string, Buffer> buffers_;
 
     // buffer variables
     unsigned int program = -1;
     unsigned int textureId = 0;
     struct Texture texture = { 0 };
-    GLuint VAO;
-    GLuint pointsVBO;
-    GLuint textCoordsVBO;
-    GLuint indexVBO;
-    std::vector<float> vertexData;  // both vertex position and texCoords points should be stored here in order to set attrib and update buffers
+    GLuint VAO = 0;
+    GLuint VBO = 0;
+    GLenum bufferUsage = GL_DYNAMIC_DRAW;
+    size_t quadCapacity = 0;  // quads VBO can hold without reallocating
+    std::string ownedText;    // labelText storage after setText()
+    std::vector<float> vertexData;  // layout positions (x, y) relative to the label origin, quantized into vertices
     std::vector<float> textCoordsData;
-    std::vector<unsigned int> indexData;  // both vertex position and texCoords points should be stored here in order to set attrib and update buffers
+    std::vector<TextVertex> vertices;  // interleaved data uploaded to VBO
+    std::vector<GlyphInstance> instances;  // data uploaded to VBO with LABEL_RENDER_INSTANCED
+    LabelRenderMode renderMode = LABEL_RENDER_VERTICES;
+    float positionScale = 1.0f;        // largest layout coordinate, vertices positions are stored divided by it
+    bool uniformsResolved = false;        // programReady() found the program linked
+    bool billboard = true;
+    int glyphFontType = FONT_SDF;         // FontType of the glyphs, selects the fragment shader variant
+    std::string vertexShaderFile;         // Shader files of the program, variants are built from them
+    std::string fragmentShaderFile;
+    unsigned int atlasGeneration = 0;     // glyphAtlas generation the vertices were built with
+    std::vector<int> atlasSlots;          // glyphAtlas slots used by the text
+    GlyphIndexTable glyphIndices;         // codepoint -> glyph index for the fixed font atlas
+
+    // Throws when the mode is not supported by the context
+    void setRenderMode(LabelRenderMode mode);
+    // True once the program is linked, resolves the uniform handles the first time. Never blocks
+    // with parallel shader compile
+    bool programReady();
+    // Layout of text from layoutCache, computed on a miss
+    const TextLayout& getLayout(const char* text);
+    // Glyph index for codepoint, from glyphAtlas when set
+    int getGlyphIndex(int codepoint);
 
     LabelShader() = default;
 };
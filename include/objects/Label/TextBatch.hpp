@@ -0,0 +1,108 @@
+#ifndef GRAPHICS_LABEL_TEXTBATCH_HPP
+#define GRAPHICS_LABEL_TEXTBATCH_HPP
+
+#include <glad/gl.h>
+//
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//
+#include "Label/GlyphAtlas.hpp"
+#include "Label/GlyphIndexTable.hpp"
+#include "Label/TextLayout.hpp"
+#include "Label/LabelShader.hpp"
+#include "Label/TextureArrayAtlas.hpp"
+#include "Label/helpers.hpp"
+#include "QuadIndexBuffer.hpp"
+#include "Shader.hpp"
+#include "math/Color.hpp"
+#include "math/Matrix4.hpp"
+#include "math/Vector3.hpp"
+
+namespace graphics {
+
+// Glyph quad corner, label origin and color are stored per vertex so labels with different
+// transforms and colors can share one vertex buffer and one draw call
+struct TextBatchVertex {
+    float x, y;                         // Corner relative to the label origin, billboarded in the vertex shader
+    float u, v;                         // Atlas texture coordinates
+    float layer;                        // TextureArrayAtlas layer, 0 for 2D atlas textures
+    float originX, originY, originZ;    // Label origin in world space
+    unsigned char r, g, b, a;           // Label color and opacity
+};
+
+// Collects the glyph quads of many labels and draws them with one glDrawElements per atlas texture,
+// fonts of a TextureArrayAtlas share one. Quads are rebuilt every frame between begin() and draw()
+// and streamed to the GPU
+// NOTE: Same billboarding and layout as LabelShader::DrawText3D(), backfaces are not generated
+struct TextBatch {
+    float lineSpace = 10.0f;  // space between lines after using \n on text
+
+    TextBatch(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const Font& font);
+    TextBatch(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, std::shared_ptr<GlyphAtlas> atlas);
+    // Text of every font in the atlas is drawn with one draw call, requires a sampler2DArray shader (sdf_array.frag)
+    TextBatch(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, std::shared_ptr<TextureArrayAtlas> atlas);
+    ~TextBatch();
+
+    TextBatch(const TextBatch&) = delete;
+    TextBatch& operator=(const TextBatch&) = delete;
+
+    // Discards the quads of the previous frame
+    void begin();
+    // Lays out text at a world position, color alpha comes from opacity
+    // NOTE: Throws std::runtime_error on a TextureArrayAtlas batch, use the fontId overload
+    void add(const char* text, const Vector3& position, const Color& color, float opacity, float fontSize, float spacing);
+    // Lays out text with a font of the texture array atlas
+    void add(const char* text, int fontId, const Vector3& position, const Color& color, float opacity, float fontSize, float spacing);
+    // Lays out a label with its own text, world position, tint and size
+    // NOTE: label.matrixWorld must be up to date, labels with another font go to their own atlas page.
+    // Labels sample 2D atlases, throws std::runtime_error on a TextureArrayAtlas batch
+    void add(const LabelShader& label);
+    // Uploads all quads and issues one draw call per atlas page
+    // NOTE: Camera matrices are read from CameraUniformBuffer, update it first
+    void draw();
+
+    int quadCount() const;
+    int drawCallCount() const;
+
+   private:
+    // Quads laid out with the same font, pages sampling the same texture are drawn together
+    struct Page {
+        Font font = { 0 };
+        GLenum textureTarget = GL_TEXTURE_2D;
+        const int* glyphLayers = nullptr;  // Layer of every glyph on TextureArrayAtlas pages
+        GlyphIndexTable glyphIndices;  // Not used for glyphAtlas pages, the atlas has its own lookup
+        std::shared_ptr<TextLayoutCache> layoutCache;
+        std::vector<TextBatchVertex> vertices;
+        std::vector<int> glyphs;  // Glyph index of every quad, used to refresh texture coordinates
+    };
+
+    Font font = { 0 };
+    std::shared_ptr<GlyphAtlas> glyphAtlas;
+    unsigned int atlasGeneration = 0;  // glyphAtlas generation the texture coordinates were built with
+    std::shared_ptr<TextureArrayAtlas> arrayAtlas;
+
+    std::vector<Page> pages;
+    int drawCalls = 0;
+
+    unsigned int program = -1;
+
+    GLuint VAO = 0;
+    GLuint VBO = 0;
+    size_t vertexCapacity = 0;  // Vertices the VBO can hold without reallocating
+
+    void createProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath);
+    void createBuffers();
+    Page& getPage(const Font& pageFont, std::shared_ptr<TextLayoutCache> layoutCache);
+    int getGlyphIndex(const Page& page, int codepoint);
+    void addText(Page& page, const char* text, const Vector3& position, const Color& color, float opacity, float fontSize, float spacing, float lineSpacing);
+    void addGlyphQuad(Page& page, int index, float x, float y, float scale, const Vector3& origin, const unsigned char color[4]);
+    static void setGlyphTexCoords(const Page& page, TextBatchVertex* quad, int index);
+};
+
+}  // namespace graphics
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef GRAPHICS_LABEL_TEXTLAYOUT_HPP
+#define GRAPHICS_LABEL_TEXTLAYOUT_HPP
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//
+#include "Label/helpers.hpp"
+
+// Maximum number of texts kept by a TextLayoutCache
+#define TEXT_LAYOUT_CACHE_SIZE 256
+
+// Kerning pairs of a font, adjustments are in pixels at the font base size
+struct KerningTable {
+    void add(const KerningPair* pairs, int count);
+    void clear();
+    bool empty() const { return pairs.empty(); }
+    // Advance adjustment between first and second, 0 when the pair is not kerned
+    float get(int first, int second) const;
+
+   private:
+    std::unordered_map<uint64_t, float> pairs;
+};
+
+// Glyph placed by the layout, spaces, tabs and line breaks only move the pen
+struct LayoutGlyph {
+    int codepoint;
+    float penX;  // Sum of the advances (kerning included) before the glyph, in pixels at the font base size
+    int column;  // Codepoints before the glyph on its line, every one adds the text spacing
+    int line;
+};
+
+// Font size and spacing independent layout of a text: they scale the pen positions linearly,
+// so one layout serves every label showing the same text
+struct TextLayout {
+    std::vector<LayoutGlyph> glyphs;
+    float maxLineAdvance = 0.0f;  // Advance of the widest line, in pixels at the font base size
+    int maxLineCodepoints = 0;    // Codepoints of the longest line
+    int lineCount = 1;
+};
+
+// Least recently used cache of text layouts for one font
+struct TextLayoutCache {
+    KerningTable kerning;
+
+    explicit TextLayoutCache(size_t capacity = TEXT_LAYOUT_CACHE_SIZE);
+
+    // Layout of text, computed on a miss. getGlyphIndex maps a codepoint to its index in font.glyphs
+    // NOTE: Returned reference is valid until the next call to get()
+    const TextLayout& get(const char* text, const Font& font, const std::function<int(int)>& getGlyphIndex);
+    // Drops every layout, required when kerning or glyph metrics change
+    void invalidate();
+    size_t size() const { return entries.size(); }
+
+   private:
+    using Entry = std::pair<std::string, TextLayout>;
+
+    size_t capacity;
+    std::list<Entry> entries;  // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> lookup;
+    std::vector<int> codepoints;  // Decoded text of the last miss, kept to reuse its storage
+
+    TextLayout build(const std::string& text, const Font& font, const std::function<int(int)>& getGlyphIndex);
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef GRAPHICS_LABEL_TEXTUREARRAYATLAS_HPP
+#define GRAPHICS_LABEL_TEXTUREARRAYATLAS_HPP
+
+#include <glad/gl.h>
+//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+//
+#include "Label/TextLayout.hpp"
+#include "Label/helpers.hpp"
+#include "stb_rect_pack.h"
+
+namespace graphics {
+
+// Glyphs of several fonts and sizes packed into the layers of one GL_TEXTURE_2D_ARRAY. When a glyph
+// does not fit on the current layer a new one is opened, so a font is never limited to one page and
+// text of every font can be drawn with a single texture binding (layer index is stored per vertex)
+// NOTE: Single channel font types only (FONT_DEFAULT, FONT_BITMAP, FONT_SDF), sampled as alpha.
+// Only TextBatch draws from it (fontId overload of add()), labels of different fonts are merged into one
+// draw call by adding their text to an array batch, a LabelShader can't use the atlas on its own
+struct TextureArrayAtlas {
+    // Font of the atlas, font.texture is the array texture and font.recs are relative to the glyph layer
+    struct AtlasFont {
+        Font font = { 0 };
+        std::vector<int> glyphLayers;  // Layer of every glyph in font.glyphs
+        std::shared_ptr<TextLayoutCache> layoutCache;
+    };
+
+    TextureArrayAtlas(int width, int height, int maxLayers);
+    ~TextureArrayAtlas();
+
+    TextureArrayAtlas(const TextureArrayAtlas&) = delete;
+    TextureArrayAtlas& operator=(const TextureArrayAtlas&) = delete;
+
+    // Rasterizes and packs the glyphs of a font, returns its id or -1 on failure
+    // NOTE: No codepoints provided (NULL) loads the 95 ASCII characters, same as LoadFontData()
+    int addFont(const std::string& fontPath, int fontSize, int fontType, const int* codepoints = NULL, int codepointCount = 0);
+    const AtlasFont& getFont(int fontId) const;
+    int fontCount() const;
+    int layerCount() const;
+    GLuint textureId() const;
+    // Uploads the layers modified since the last flush with glTexSubImage3D
+    void flush();
+
+   private:
+    struct Layer {
+        std::vector<unsigned char> pixels;  // CPU copy of the layer (1 byte per pixel)
+        std::vector<stbrp_node> packNodes;
+        std::unique_ptr<stbrp_context> packContext;  // NOTE: Points into packNodes
+        int dirtyMinY = 0;  // Rows modified since the last flush, empty when dirtyMinY >= dirtyMaxY
+        int dirtyMaxY = 0;
+    };
+
+    int width = 0;
+    int height = 0;
+    int maxLayers = 0;
+    int padding = 1;  // Empty pixels around every glyph, avoids bleeding with bilinear filtering
+
+    GLuint texture = 0;
+    int layerCapacity = 0;  // Layers allocated on the GPU, grows by doubling up to maxLayers
+    std::vector<std::unique_ptr<Layer>> layers;
+    std::vector<std::unique_ptr<AtlasFont>> fonts;  // NOTE: Fonts are never moved, pointers to them stay valid
+
+    bool addLayer();
+    bool packGlyph(const GlyphInfo& glyph, Rectangle* rec, int* layer);
+    void reserveLayers(int count);
+};
+
+}  // namespace graphics
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef GRAPHICS_LABEL_UTF8_HPP
+#define GRAPHICS_LABEL_UTF8_HPP
+
+#include <cstddef>
+#include <vector>
+
+// Bulk UTF-8 decoding for label text. Runs of ASCII bytes are widened 16 (SSE2) or 32 (AVX2)
+// bytes at a time, multibyte sequences are decoded and validated one by one. The kernel is
+// picked once at runtime, other architectures use the scalar loop
+
+// Appends the codepoints of text to codepoints, returns the number of invalid bytes
+// NOTE: Every invalid byte (bad lead or continuation byte, overlong form, surrogate, value above
+// U+10FFFF, truncated sequence) is decoded as '?', same as the bad bytes drawn by DrawText3D()
+size_t DecodeUtf8(const char* text, size_t length, std::vector<int>& codepoints);
+// True when text is well formed UTF-8
+bool ValidateUtf8(const char* text, size_t length);
+// Number of codepoints in text, exact for well formed UTF-8
+size_t CountUtf8Codepoints(const char* text, size_t length);
+// Name of the kernel used by the functions above ("AVX2", "SSE2" or "scalar")
+const char* GetUtf8KernelName();
+
+#endif
@@ -47,7 +47,8 @@ typedef enum {
     PIXELFORMAT_COMPRESSED_PVRT_RGB,         // 4 bpp
     PIXELFORMAT_COMPRESSED_PVRT_RGBA,        // 4 bpp
     PIXELFORMAT_COMPRESSED_ASTC_4x4_RGBA,    // 8 bpp
-    PIXELFORMAT_COMPRESSED_ASTC_8x8_RGBA     // 2 bpp
+    PIXELFORMAT_COMPRESSED_ASTC_8x8_RGBA,    // 2 bpp
+    PIXELFORMAT_COMPRESSED_RGTC1_R           // 4 bpp (1 channel, BC4)
 } PixelFormat;
 // Texture pixel formats
 // NOTE: Support depends on OpenGL version
@@ -75,14 +76,46 @@ typedef enum {
     RL_PIXELFORMAT_COMPRESSED_PVRT_RGB,         // 4 bpp
     RL_PIXELFORMAT_COMPRESSED_PVRT_RGBA,        // 4 bpp
     RL_PIXELFORMAT_COMPRESSED_ASTC_4x4_RGBA,    // 8 bpp
-    RL_PIXELFORMAT_COMPRESSED_ASTC_8x8_RGBA     // 2 bpp
+    RL_PIXELFORMAT_COMPRESSED_ASTC_8x8_RGBA,    // 2 bpp
+    RL_PIXELFORMAT_COMPRESSED_RGTC1_R           // 4 bpp (1 channel, BC4)
 } rlPixelFormat;
 // Font type, defines generation method
 typedef enum {
     FONT_DEFAULT = 0,  // Default font generation, anti-aliased
     FONT_BITMAP,       // Bitmap font generation, no anti-aliasing
-    FONT_SDF           // SDF font generation, requires external shader
+    FONT_SDF,          // SDF font generation, requires external shader
+    FONT_MSDF          // Multi-channel SDF font generation (RGB), requires external shader (msdf.frag)
 } FontType;
+// NOTE: Using some SDF generation default values,
+// trades off precision with ability to handle *smaller* sizes
+#ifndef FONT_SDF_CHAR_PADDING
+#define FONT_SDF_CHAR_PADDING 4  // SDF font generation char padding
+#endif
+#ifndef FONT_SDF_ON_EDGE_VALUE
+#define FONT_SDF_ON_EDGE_VALUE 128  // SDF font generation on edge value
+#endif
+#ifndef FONT_SDF_PIXEL_DIST_SCALE
+#define FONT_SDF_PIXEL_DIST_SCALE 64.0f  // SDF font generation pixel distance scale
+#endif
+#ifndef FONT_SDF_SUPERSAMPLE
+#define FONT_SDF_SUPERSAMPLE 4  // SDF glyphs are rasterized this many times bigger and converted with a distance transform, 0 uses stbtt_GetCodepointSDF()
+#endif
+#ifndef FONT_ATLAS_COMPRESSION
+#define FONT_ATLAS_COMPRESSION 0  // Single channel font atlases are encoded to RGTC1 (BC4) on the CPU, 0.5 byte per pixel: half the size of GRAYSCALE (R8, 1 byte) and a quarter of GRAY_ALPHA (2 bytes)
+#endif
+#ifndef FONT_BITMAP_ALPHA_THRESHOLD
+#define FONT_BITMAP_ALPHA_THRESHOLD 80  // Bitmap (B&W) font generation alpha threshold
+#endif
+// Glyph generation on LoadFontData() is split between worker threads for bigger codepoint sets
+#ifndef FONT_LOAD_MAX_THREADS
+#define FONT_LOAD_MAX_THREADS 16  // Maximum number of threads generating glyphs
+#endif
+#ifndef FONT_LOAD_MIN_GLYPHS_PER_THREAD
+#define FONT_LOAD_MIN_GLYPHS_PER_THREAD 16  // Below this amount of glyphs per thread it is faster to do it serially
+#endif
+#ifndef FONT_LOAD_GLYPHS_PER_BATCH
+#define FONT_LOAD_GLYPHS_PER_BATCH 4  // Glyphs taken by a worker each time
+#endif
 // Texture parameters: filter mode
 // NOTE 1: Filtering considers mipmaps if available in the texture
 // NOTE 2: Filter is accordingly set for minification and magnification
@@ -139,6 +172,17 @@ typedef struct Font {
     GlyphInfo *glyphs;  // Glyphs info data
 } Font;
 
+// KerningPair, advance adjustment between two consecutive codepoints
+typedef struct KerningPair {
+    int first;      // Left codepoint
+    int second;     // Right codepoint
+    float advance;  // Adjustment in pixels at the font size used to load it
+} KerningPair;
+
+// KerningSource, kerning of one font looked up one codepoint at a time (atlases filled on demand)
+// NOTE: Keeps a pointer to the font data, it must outlive the source
+typedef struct KerningSource KerningSource;
+
 /******** FUNCTIONS *********/
 
 unsigned char *LoadFileData(const char *fileName, int *dataSize);
@@ -146,6 +190,18 @@ unsigned char *LoadFileData(const char *fileName, int *dataSize);
 // NOTE: Requires TTF font memory data and can generate SDF data
 GlyphInfo *LoadFontData(const unsigned char *fileData, int dataSize, int fontSize, int *codepoints, int codepointCount, int type);
 Image GenImageFontAtlas(const GlyphInfo *glyphs, Rectangle **glyphRecs, int glyphCount, int fontSize, int padding, int packMethod);
+// Load kerning (GPOS or kern table) of every pair (first, second) with a non zero adjustment
+// NOTE: Returned array must be freed, pairCount is set to its size
+KerningPair *LoadFontKerning(const unsigned char *fileData, int dataSize, int fontSize, const int *firstCodepoints, int firstCount, const int *secondCodepoints, int secondCount, int *pairCount);
+// Load kerning source, a kern table is read once here
+KerningSource *LoadKerningSource(const unsigned char *fileData, int dataSize, int fontSize);
+// Add codepoint to the source, returns its pairs with itself and every codepoint added before, both ways
+// NOTE: Returned array must be freed, NULL when codepoint was already added or has no pairs
+KerningPair *AddKerningCodepoint(KerningSource *source, int codepoint, int *pairCount);
+void UnloadKerningSource(KerningSource *source);
+// Encode a GRAYSCALE image to PIXELFORMAT_COMPRESSED_RGTC1_R (BC4), 8 bytes per 4x4 block
+// NOTE: Only the first mipmap level is kept, returns false when the image is not GRAYSCALE
+bool ImageCompressRGTC1(Image *image);
 int rlGetPixelDataSize(int width, int height, int format);
 void rlGetGlTextureFormats(int format, unsigned int *glInternalFormat, unsigned int *glFormat, unsigned int *glType);
 const char *rlGetPixelFormatName(unsigned int format);
@@ -155,7 +211,7 @@ void rlTextureParameters(unsigned int id, int param, int value);
 void SetTextureFilter(Texture texture, int filter);
 
 int GetCodepointNext(const char *text, int *codepointSize);
-int GetGlyphIndex(Font font, int codepoint);
+int GetGlyphIndex(const Font &font, int codepoint);
 unsigned int TextLength(const char *text);
 void SetTextLineSpacing(int spacing);
 
@@ -0,0 +1,60 @@
+#include "CameraUniformBuffer.hpp"
+
+#include <algorithm>
+
+#include "GLDebug.hpp"
+
+namespace {
+
+// Copies matrix into values, true when they differed
+bool CopyMatrix(const graphics::Matrix4& matrix, float* values) {
+    if (std::equal(matrix.elements.begin(), matrix.elements.end(), values)) return false;
+
+    std::copy(matrix.elements.begin(), matrix.elements.end(), values);
+    return true;
+}
+
+}  // namespace
+
+CameraUniformBuffer& CameraUniformBuffer::instance() {
+    static CameraUniformBuffer buffer;
+    return buffer;
+}
+
+bool CameraUniformBuffer::update(const graphics::Camera& camera) {
+    bool changed = CopyMatrix(camera.matrixWorldInverse, block.view);
+    changed |= CopyMatrix(camera.projectionMatrix, block.projection);
+    changed |= CopyMatrix(*camera.matrixWorld, block.viewInverse);
+    changed |= CopyMatrix(camera.projectionMatrixInverse, block.projectionInverse);
+
+    if (!changed && uploaded) return false;
+
+    GL_DEBUG_MARK();
+    if (bufferId == 0) {
+        glGenBuffers(1, &bufferId);
+        glBindBuffer(GL_UNIFORM_BUFFER, bufferId);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), &block, GL_DYNAMIC_DRAW);
+        // NOTE: The indexed binding is kept, nothing else uses CAMERA_UNIFORM_BINDING
+        glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_UNIFORM_BINDING, bufferId);
+    } else {
+        glBindBuffer(GL_UNIFORM_BUFFER, bufferId);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &block);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    uploaded = true;
+    return true;
+}
+
+void CameraUniformBuffer::bindBlock(GLuint program) {
+    // NOTE: layout(binding = N) needs GLSL 420, the window asks for a 3.2 context
+    GLuint blockIndex = glGetUniformBlockIndex(program, CAMERA_UNIFORM_BLOCK);
+    if (blockIndex != GL_INVALID_INDEX) glUniformBlockBinding(program, blockIndex, CAMERA_UNIFORM_BINDING);
+}
+
+void CameraUniformBuffer::release() {
+    if (bufferId != 0) glDeleteBuffers(1, &bufferId);
+
+    bufferId = 0;
+    uploaded = false;
+}
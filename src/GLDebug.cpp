@@ -0,0 +1,123 @@
+#include "GLDebug.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+std::atomic<const GLDebugSite*> lastSite{ nullptr };
+bool installed = false;
+
+#ifdef GRAPHICS_GL_DEBUG
+const char* SourceName(GLenum source) {
+    switch (source) {
+        case GL_DEBUG_SOURCE_API:
+            return "API";
+        case GL_DEBUG_SOURCE_WINDOW_SYSTEM:
+            return "window system";
+        case GL_DEBUG_SOURCE_SHADER_COMPILER:
+            return "shader compiler";
+        case GL_DEBUG_SOURCE_THIRD_PARTY:
+            return "third party";
+        case GL_DEBUG_SOURCE_APPLICATION:
+            return "application";
+        default:
+            return "other";
+    }
+}
+
+const char* TypeName(GLenum type) {
+    switch (type) {
+        case GL_DEBUG_TYPE_ERROR:
+            return "ERROR";
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
+            return "deprecated behavior";
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
+            return "undefined behavior";
+        case GL_DEBUG_TYPE_PORTABILITY:
+            return "portability";
+        case GL_DEBUG_TYPE_PERFORMANCE:
+            return "performance";
+        default:
+            return "other";
+    }
+}
+
+const char* SeverityName(GLenum severity) {
+    switch (severity) {
+        case GL_DEBUG_SEVERITY_HIGH:
+            return "high";
+        case GL_DEBUG_SEVERITY_MEDIUM:
+            return "medium";
+        case GL_DEBUG_SEVERITY_LOW:
+            return "low";
+        default:
+            return "notification";
+    }
+}
+
+void GLAD_API_PTR DebugMessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam) {
+    (void)length;
+    (void)userParam;
+
+    std::cerr << "OpenGL " << TypeName(type) << " (" << SourceName(source) << ", " << SeverityName(severity) << ", id " << id << "): " << message << std::endl;
+
+    const GLDebugSite* site = lastSite.load(std::memory_order_relaxed);
+    if (site != nullptr) std::cerr << "    after " << site->function << " (" << site->file << ":" << site->line << ")" << std::endl;
+}
+#endif
+
+}  // namespace
+
+bool InstallGLDebugOutput(GLADloadfunc getProcAddress) {
+#ifdef GRAPHICS_GL_DEBUG
+    // glad only loads the entry points on 4.3 contexts, GL_KHR_debug exposes the same unsuffixed functions on older ones
+    if ((glDebugMessageCallback == NULL) && HasGLExtension("GL_KHR_debug")) {
+        glad_glDebugMessageCallback = (PFNGLDEBUGMESSAGECALLBACKPROC)getProcAddress("glDebugMessageCallback");
+        glad_glDebugMessageControl = (PFNGLDEBUGMESSAGECONTROLPROC)getProcAddress("glDebugMessageControl");
+    }
+
+    if ((glDebugMessageCallback == NULL) || (glDebugMessageControl == NULL)) {
+        std::cerr << "OpenGL debug output not available, requires OpenGL 4.3 or GL_KHR_debug" << std::endl;
+        return false;
+    }
+
+    glDebugMessageCallback(DebugMessageCallback, NULL);
+    // Notifications (buffer placement and similar) are too verbose to be useful
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, NULL, GL_FALSE);
+    // NOTE: GL_DEBUG_OUTPUT_SYNCHRONOUS is left disabled, it would serialize the driver like glGetError()
+    glEnable(GL_DEBUG_OUTPUT);
+
+    installed = true;
+    return true;
+#else
+    (void)getProcAddress;
+    return false;
+#endif
+}
+
+void SetGLDebugOutputEnabled(bool enabled) {
+    if (!installed) return;
+
+    if (enabled)
+        glEnable(GL_DEBUG_OUTPUT);
+    else
+        glDisable(GL_DEBUG_OUTPUT);
+}
+
+void SetGLDebugSite(const GLDebugSite* site) {
+    lastSite.store(site, std::memory_order_relaxed);
+}
+
+bool HasGLExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+    for (GLint i = 0; i < count; i++) {
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+        if ((extension != NULL) && (strcmp(extension, name) == 0)) return true;
+    }
+
+    return false;
+}
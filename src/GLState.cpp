@@ -0,0 +1,249 @@
+#include "GLState.hpp"
+
+GLState& GLState::instance() {
+    static GLState state;
+    return state;
+}
+
+GLState::GLState() {
+    invalidate();
+}
+
+void GLState::enable(GLenum capability) {
+    setCapability(capability, true);
+}
+
+void GLState::disable(GLenum capability) {
+    setCapability(capability, false);
+}
+
+void GLState::setCapability(GLenum capability, bool enabled) {
+    int index = -1;
+    switch (capability) {
+        case GL_BLEND:
+            index = CAP_BLEND;
+            break;
+        case GL_CULL_FACE:
+            index = CAP_CULL_FACE;
+            break;
+        case GL_DEPTH_TEST:
+            index = CAP_DEPTH_TEST;
+            break;
+        case GL_SCISSOR_TEST:
+            index = CAP_SCISSOR_TEST;
+            break;
+        case GL_STENCIL_TEST:
+            index = CAP_STENCIL_TEST;
+            break;
+        default:
+            break;
+    }
+
+    if (index == -1) {
+        stats.issuedCalls++;
+    } else {
+        if (!changed(capabilities[index] != (int)enabled)) return;
+        capabilities[index] = (int)enabled;
+    }
+
+    if (enabled)
+        glEnable(capability);
+    else
+        glDisable(capability);
+}
+
+void GLState::cullFace(GLenum mode) {
+    if (!changed(cullMode != mode)) return;
+
+    cullMode = mode;
+    glCullFace(mode);
+}
+
+void GLState::frontFace(GLenum mode) {
+    if (!changed(frontMode != mode)) return;
+
+    frontMode = mode;
+    glFrontFace(mode);
+}
+
+void GLState::blendFunc(GLenum sfactor, GLenum dfactor) {
+    if (!changed((blendSource != sfactor) || (blendDestination != dfactor))) return;
+
+    blendSource = sfactor;
+    blendDestination = dfactor;
+    glBlendFunc(sfactor, dfactor);
+}
+
+void GLState::depthMask(GLboolean flag) {
+    if (!changed(depthWrite != (GLuint)flag)) return;
+
+    depthWrite = flag;
+    glDepthMask(flag);
+}
+
+void GLState::colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) {
+    GLuint bits = (red ? 1 : 0) | (green ? 2 : 0) | (blue ? 4 : 0) | (alpha ? 8 : 0);
+    if (!changed(colorWrite != bits)) return;
+
+    colorWrite = bits;
+    glColorMask(red, green, blue, alpha);
+}
+
+void GLState::stencilMask(GLuint mask) {
+    if (!changed(!stencilWriteKnown || (stencilWrite != mask))) return;
+
+    stencilWriteKnown = true;
+    stencilWrite = mask;
+    glStencilMask(mask);
+}
+
+void GLState::stencilFunc(GLenum func, GLint ref, GLuint mask) {
+    if (!changed((stencilFunction != func) || (stencilRef != ref) || (stencilFuncMask != mask))) return;
+
+    stencilFunction = func;
+    stencilRef = ref;
+    stencilFuncMask = mask;
+    glStencilFunc(func, ref, mask);
+}
+
+void GLState::stencilOp(GLenum sfail, GLenum dpfail, GLenum dppass) {
+    if (!changed((stencilFail != sfail) || (stencilDepthFail != dpfail) || (stencilPass != dppass))) return;
+
+    stencilFail = sfail;
+    stencilDepthFail = dpfail;
+    stencilPass = dppass;
+    glStencilOp(sfail, dpfail, dppass);
+}
+
+void GLState::useProgram(GLuint newProgram) {
+    if (!changed(program != newProgram)) return;
+
+    program = newProgram;
+    glUseProgram(newProgram);
+}
+
+void GLState::bindVertexArray(GLuint newVertexArray) {
+    if (!changed(vertexArray != newVertexArray)) return;
+
+    vertexArray = newVertexArray;
+    glBindVertexArray(newVertexArray);
+}
+
+void GLState::activeTexture(GLenum unit) {
+    if (!changed(textureUnit != unit)) return;
+
+    textureUnit = unit;
+    glActiveTexture(unit);
+}
+
+void GLState::bindTexture(GLenum target, GLuint texture) {
+    GLuint* binding = nullptr;
+    unsigned int unit = textureUnit - GL_TEXTURE0;
+
+    // Active unit must be known to know which binding changes
+    if ((textureUnit != UNKNOWN) && (unit < GLSTATE_MAX_TEXTURE_UNITS)) {
+        if (target == GL_TEXTURE_2D) binding = &textures2D[unit];
+        if (target == GL_TEXTURE_2D_ARRAY) binding = &texturesArray[unit];
+    }
+
+    if (binding == nullptr) {
+        stats.issuedCalls++;
+        glBindTexture(target, texture);
+
+        // Unit is not known, any shadowed binding of target could have changed
+        if ((textureUnit == UNKNOWN) && ((target == GL_TEXTURE_2D) || (target == GL_TEXTURE_2D_ARRAY))) {
+            for (int i = 0; i < GLSTATE_MAX_TEXTURE_UNITS; i++) (target == GL_TEXTURE_2D ? textures2D[i] : texturesArray[i]) = UNKNOWN;
+        }
+        return;
+    }
+
+    if (!changed(*binding != texture)) return;
+
+    *binding = texture;
+    glBindTexture(target, texture);
+}
+
+void GLState::deleteProgram(GLuint deletedProgram) {
+    // NOTE: A program in use is only flagged for deletion, its name is freed once it is no longer current
+    if (program == deletedProgram) useProgram(0);
+
+    glDeleteProgram(deletedProgram);
+}
+
+void GLState::deleteVertexArray(GLuint deletedVertexArray) {
+    glDeleteVertexArrays(1, &deletedVertexArray);
+
+    // Deleting the bound vertex array binds 0
+    if (vertexArray == deletedVertexArray) vertexArray = 0;
+}
+
+void GLState::deleteTexture(GLuint texture) {
+    glDeleteTextures(1, &texture);
+
+    // Deleting a texture unbinds it from every unit
+    for (int i = 0; i < GLSTATE_MAX_TEXTURE_UNITS; i++) {
+        if (textures2D[i] == texture) textures2D[i] = 0;
+        if (texturesArray[i] == texture) texturesArray[i] = 0;
+    }
+}
+
+void GLState::invalidate() {
+    for (int i = 0; i < CAP_COUNT; i++) capabilities[i] = -1;
+
+    cullMode = UNKNOWN;
+    frontMode = UNKNOWN;
+    blendSource = UNKNOWN;
+    blendDestination = UNKNOWN;
+    depthWrite = UNKNOWN;
+    colorWrite = UNKNOWN;
+    stencilWriteKnown = false;
+    stencilWrite = 0;
+    stencilFunction = UNKNOWN;
+    stencilRef = 0;
+    stencilFuncMask = 0;
+    stencilFail = UNKNOWN;
+    stencilDepthFail = UNKNOWN;
+    stencilPass = UNKNOWN;
+
+    program = UNKNOWN;
+    vertexArray = UNKNOWN;
+    textureUnit = UNKNOWN;
+    for (int i = 0; i < GLSTATE_MAX_TEXTURE_UNITS; i++) {
+        textures2D[i] = UNKNOWN;
+        texturesArray[i] = UNKNOWN;
+    }
+}
+
+void GLState::invalidateBindings(GLenum unit) {
+    program = UNKNOWN;
+    vertexArray = UNKNOWN;
+    textureUnit = UNKNOWN;
+
+    unsigned int index = unit - GL_TEXTURE0;
+    if (index < GLSTATE_MAX_TEXTURE_UNITS) {
+        textures2D[index] = UNKNOWN;
+        texturesArray[index] = UNKNOWN;
+    }
+}
+
+void GLState::beginFrame() {
+    lastStats = stats;
+    stats = GLStateStats();
+}
+
+const GLStateStats& GLState::frameStats() const {
+    return stats;
+}
+
+const GLStateStats& GLState::lastFrameStats() const {
+    return lastStats;
+}
+
+bool GLState::changed(bool differs) {
+    if (differs)
+        stats.issuedCalls++;
+    else
+        stats.elidedCalls++;
+
+    return differs;
+}
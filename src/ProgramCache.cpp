@@ -0,0 +1,312 @@
+#include "ProgramCache.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include "GLDebug.hpp"
+#include "Hash.hpp"
+#include "MappedFile.hpp"
+
+namespace {
+
+// On-disk layout: ProgramCacheHeader | program binary
+struct ProgramCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t keyHash;
+    uint32_t binaryFormat;
+    uint32_t binarySize;
+};
+
+const char PROGRAM_CACHE_MAGIC[4] = { 'G', 'L', 'P', 'B' };
+
+void CheckCompilationErrors(GLuint shaderId, GLenum shaderType) {
+    GLint success;
+    glGetShaderiv(shaderId, GL_COMPILE_STATUS, &success);
+    GLchar infoLog[512];
+    glGetShaderInfoLog(shaderId, sizeof(infoLog), nullptr, infoLog);
+    if (!success) {
+        std::cerr << "Error compiling " << (shaderType == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader:"
+                  << infoLog << std::endl;
+        throw std::runtime_error("Shader compilation failed");
+    }
+}
+
+// Compile status is not queried here, the driver can keep compiling until the program is checked
+unsigned int createShader(int shaderType, const char* sourceCode) {
+    GL_DEBUG_MARK();
+    GLuint shaderId = glCreateShader(shaderType);
+    // NOTE: 0 is returned for an invalid shaderType, the debug output reports the GL error
+    if (shaderId == 0) {
+        std::cerr << "Failed to create shader of type " << shaderType << std::endl;
+        throw std::runtime_error("Shader creation failed");
+    }
+
+    glShaderSource(shaderId, 1, &sourceCode, nullptr);
+    glCompileShader(shaderId);
+
+    return shaderId;
+}
+
+bool IsLinked(GLuint program) {
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+
+    return success == GL_TRUE;
+}
+
+// GL_COMPLETION_STATUS_KHR can be queried
+bool parallelCompile = false;
+
+using MaxShaderCompilerThreadsProc = void(GLAD_API_PTR*)(GLuint count);
+
+// Program binaries are core since OpenGL 4.1, drivers may still expose no binary format
+bool ProgramBinarySupported() {
+    static int supported = -1;
+
+    if (supported == -1) {
+        GLint formats = 0;
+        if ((glGetProgramBinary != NULL) && (glProgramBinary != NULL) && (glProgramParameteri != NULL)) glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        supported = (formats > 0) ? 1 : 0;
+    }
+
+    return supported == 1;
+}
+
+uint64_t HashString(const char* text, uint64_t hash) {
+    return (text != NULL) ? HashBytes(text, strlen(text), hash) : hash;
+}
+
+// Binaries are only valid for the driver that produced them
+uint64_t MakeProgramKey(const std::string& vertexGlsl, const std::string& fragmentGlsl) {
+    uint32_t version = PROGRAM_CACHE_VERSION;
+    uint64_t key = HashBytes(&version, sizeof(version));
+    key = HashBytes(vertexGlsl.data(), vertexGlsl.size(), key);
+    key = HashBytes("\0", 1, key);  // "ab" + "c" and "a" + "bc" must differ
+    key = HashBytes(fragmentGlsl.data(), fragmentGlsl.size(), key);
+    key = HashString((const char*)glGetString(GL_VENDOR), key);
+    key = HashString((const char*)glGetString(GL_RENDERER), key);
+    key = HashString((const char*)glGetString(GL_VERSION), key);
+
+    return key;
+}
+
+std::string GetProgramCachePath(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, uint64_t key) {
+    std::filesystem::path vertexPath(vertexShaderPath);
+
+    std::ostringstream fileName;
+    fileName << vertexPath.stem().string() << "_" << std::filesystem::path(fragmentShaderPath).stem().string() << "_" << std::hex << std::setw(16) << std::setfill('0') << key << ".programcache";
+
+    return (vertexPath.parent_path() / "cache" / fileName.str()).string();
+}
+
+// Returns 0 when there is no usable binary for key
+GLuint LoadProgramBinary(const std::string& cachePath, uint64_t key) {
+    MappedFile file;
+    if (!file.open(cachePath)) return 0;
+
+    ProgramCacheHeader header;
+    if (file.size() < sizeof(header)) return 0;
+    memcpy(&header, file.data(), sizeof(header));
+
+    bool valid = (memcmp(header.magic, PROGRAM_CACHE_MAGIC, sizeof(PROGRAM_CACHE_MAGIC)) == 0) &&
+                 (header.version == PROGRAM_CACHE_VERSION) &&
+                 (header.keyHash == key) &&
+                 (file.size() == sizeof(header) + header.binarySize);
+    if (!valid) return 0;
+
+    GLuint program = glCreateProgram();
+    GL_DEBUG_MARK();
+    glProgramBinary(program, header.binaryFormat, file.data() + sizeof(header), (GLsizei)header.binarySize);
+
+    // NOTE: Drivers reject binaries after an update even when the version string did not change
+    if (!IsLinked(program)) {
+        std::cout << "Program binary [" << cachePath << "] rejected by the driver, linking from source" << std::endl;
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    return program;
+}
+
+bool SaveProgramBinary(const std::string& cachePath, uint64_t key, GLuint program) {
+    GLint binarySize = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+    if (binarySize <= 0) return false;
+
+    std::vector<unsigned char> binary(binarySize);
+    GLenum binaryFormat = 0;
+    glGetProgramBinary(program, binarySize, &binarySize, &binaryFormat, binary.data());
+
+    ProgramCacheHeader header = { 0 };
+    memcpy(header.magic, PROGRAM_CACHE_MAGIC, sizeof(PROGRAM_CACHE_MAGIC));
+    header.version = PROGRAM_CACHE_VERSION;
+    header.keyHash = key;
+    header.binaryFormat = binaryFormat;
+    header.binarySize = (uint32_t)binarySize;
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+
+    // Write to a temporary file first so a crash never leaves a half written cache behind
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream cacheFile(tempPath, std::ios::binary | std::ios::trunc);
+        if (!cacheFile.is_open()) {
+            std::cerr << "Failed to create program cache file: " << cachePath << std::endl;
+            return false;
+        }
+
+        cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        cacheFile.write(reinterpret_cast<const char*>(binary.data()), binarySize);
+
+        if (!cacheFile.good()) {
+            cacheFile.close();
+            std::filesystem::remove(tempPath, error);
+            std::cerr << "Failed to write program cache file: " << cachePath << std::endl;
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        std::cerr << "Failed to store program cache file: " << cachePath << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+ProgramBuild SubmitLink(const std::string& vertexGlsl, const std::string& fragmentGlsl, const ProgramSetup& beforeLink, bool retrievable) {
+    ProgramBuild build;
+    build.vertexShader = createShader(GL_VERTEX_SHADER, vertexGlsl.c_str());
+    build.fragmentShader = createShader(GL_FRAGMENT_SHADER, fragmentGlsl.c_str());
+
+    build.program = glCreateProgram();
+    glAttachShader(build.program, build.vertexShader);
+    glAttachShader(build.program, build.fragmentShader);
+
+    if (beforeLink) beforeLink(build.program);
+    if (retrievable) glProgramParameteri(build.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+    glLinkProgram(build.program);
+
+    return build;
+}
+
+// Shaders are flagged for deletion, the program keeps them until it is deleted
+void DeleteShaders(ProgramBuild& build) {
+    glDeleteShader(build.vertexShader);
+    glDeleteShader(build.fragmentShader);
+    build.vertexShader = 0;
+    build.fragmentShader = 0;
+}
+
+GLuint FinishOrDelete(ProgramBuild& build) {
+    try {
+        return FinishProgram(build);
+    } catch (const std::runtime_error&) {
+        glDeleteProgram(build.program);
+        throw;
+    }
+}
+
+}  // namespace
+
+bool InstallParallelShaderCompile(GLADloadfunc getProcAddress) {
+    const char* entryPoint = NULL;
+    if (HasGLExtension("GL_KHR_parallel_shader_compile"))
+        entryPoint = "glMaxShaderCompilerThreadsKHR";
+    else if (HasGLExtension("GL_ARB_parallel_shader_compile"))
+        entryPoint = "glMaxShaderCompilerThreadsARB";
+
+    MaxShaderCompilerThreadsProc maxShaderCompilerThreads = NULL;
+    if (entryPoint != NULL) maxShaderCompilerThreads = (MaxShaderCompilerThreadsProc)getProcAddress(entryPoint);
+
+    if (maxShaderCompilerThreads == NULL) {
+        std::cout << "Parallel shader compile not available, requires GL_KHR_parallel_shader_compile" << std::endl;
+        return false;
+    }
+
+    // 0xFFFFFFFF lets the driver choose the number of compiler threads
+    maxShaderCompilerThreads(0xFFFFFFFF);
+
+    parallelCompile = true;
+    return true;
+}
+
+GLuint LoadProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const ShaderDefines& defines, const ProgramSetup& beforeLink) {
+    ProgramBuild build = SubmitProgram(vertexShaderPath, fragmentShaderPath, defines, beforeLink);
+
+    return FinishOrDelete(build);
+}
+
+GLuint LinkProgramFromSource(const std::string& vertexGlsl, const std::string& fragmentGlsl, const ProgramSetup& beforeLink) {
+    ProgramBuild build = SubmitLink(vertexGlsl, fragmentGlsl, beforeLink, false);
+
+    return FinishOrDelete(build);
+}
+
+ProgramBuild SubmitProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const ShaderDefines& defines, const ProgramSetup& beforeLink) {
+    const std::string& vertexGlsl = PreprocessShader(vertexShaderPath, defines);
+    const std::string& fragmentGlsl = PreprocessShader(fragmentShaderPath, defines);
+
+    if (!PROGRAM_BINARY_CACHE || !ProgramBinarySupported()) return SubmitLink(vertexGlsl, fragmentGlsl, beforeLink, false);
+
+    uint64_t key = MakeProgramKey(vertexGlsl, fragmentGlsl);
+    std::string cachePath = GetProgramCachePath(vertexShaderPath, fragmentShaderPath, key);
+
+    // NOTE: Binaries are checked right away, a rejected one still has its sources at hand
+    ProgramBuild build;
+    build.program = LoadProgramBinary(cachePath, key);
+    if (build.program != 0) return build;
+
+    build = SubmitLink(vertexGlsl, fragmentGlsl, beforeLink, true);
+    build.cachePath = cachePath;
+    build.key = key;
+
+    return build;
+}
+
+bool IsProgramBuildComplete(const ProgramBuild& build) {
+    if (!parallelCompile || (build.vertexShader == 0)) return true;
+
+    GLint complete = GL_FALSE;
+    glGetProgramiv(build.program, GL_COMPLETION_STATUS_KHR, &complete);
+
+    return complete == GL_TRUE;
+}
+
+GLuint FinishProgram(ProgramBuild& build) {
+    if (build.vertexShader == 0) return build.program;  // Loaded from a binary
+
+    // Compile errors explain a failed link better than the link log
+    try {
+        CheckCompilationErrors(build.vertexShader, GL_VERTEX_SHADER);
+        CheckCompilationErrors(build.fragmentShader, GL_FRAGMENT_SHADER);
+    } catch (const std::runtime_error&) {
+        DeleteShaders(build);
+        throw;
+    }
+
+    DeleteShaders(build);
+
+    if (!IsLinked(build.program)) {
+        GLchar infoLog[512];
+        glGetProgramInfoLog(build.program, sizeof(infoLog), nullptr, infoLog);
+        std::cerr << "Error linking program:" << infoLog << std::endl;
+        throw std::runtime_error("Program linking failed");
+    }
+
+    if (!build.cachePath.empty()) SaveProgramBinary(build.cachePath, build.key, build.program);
+
+    return build.program;
+}
@@ -0,0 +1,123 @@
+#include "ProgramRegistry.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+#include "CameraUniformBuffer.hpp"
+#include "GLState.hpp"
+#include "Hash.hpp"
+
+namespace {
+
+// Programs are shared by source, not by path: the same files reached through another path
+// (or wrappers preprocessing to the same text) reuse the program
+uint64_t MakeKey(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const ShaderDefines& defines) {
+    const std::string& vertexGlsl = PreprocessShader(vertexShaderPath, defines);
+    const std::string& fragmentGlsl = PreprocessShader(fragmentShaderPath, defines);
+    std::string definesKey = ShaderDefinesKey(defines);
+
+    uint64_t key = HashBytes(vertexGlsl.data(), vertexGlsl.size());
+    key = HashBytes("\0", 1, key);  // "ab" + "c" and "a" + "bc" must differ
+    key = HashBytes(fragmentGlsl.data(), fragmentGlsl.size(), key);
+    key = HashBytes("\0", 1, key);
+
+    return HashBytes(definesKey.data(), definesKey.size(), key);
+}
+
+}  // namespace
+
+ProgramRegistry& ProgramRegistry::instance() {
+    static ProgramRegistry registry;
+    return registry;
+}
+
+GLuint ProgramRegistry::acquire(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const ShaderDefines& defines, const ProgramSetup& beforeLink) {
+    uint64_t key = MakeKey(vertexShaderPath, fragmentShaderPath, defines);
+
+    auto it = programIds.find(key);
+    if (it != programIds.end()) {
+        programs[it->second].references++;
+        return it->second;
+    }
+
+    ProgramBuild build = SubmitProgram(vertexShaderPath, fragmentShaderPath, defines, beforeLink);
+    GLuint program = build.program;
+
+    Entry& entry = programs[program];
+    entry.key = key;
+    entry.references = 1;
+    entry.build = build;
+    programIds[key] = program;
+
+    return program;
+}
+
+bool ProgramRegistry::ready(GLuint program) {
+    auto it = programs.find(program);
+    if (it == programs.end()) return false;
+
+    Entry& entry = it->second;
+    if (entry.linked) return true;
+    if (entry.failed || !IsProgramBuildComplete(entry.build)) return false;
+
+    // NOTE: Called from the frame loop, a broken variant is reported here once and then skipped
+    try {
+        finish(program, entry);
+    } catch (const std::runtime_error& error) {
+        std::cerr << "Program " << program << " failed to build, it will not be drawn: " << error.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void ProgramRegistry::wait(GLuint program) {
+    auto it = programs.find(program);
+    if ((it == programs.end()) || it->second.linked) return;
+    // NOTE: The error was logged by the first check, later users of the same files still have to fail
+    if (it->second.failed) throw std::runtime_error("Program failed to compile or link");
+
+    finish(program, it->second);
+}
+
+void ProgramRegistry::finish(GLuint program, Entry& entry) {
+    // NOTE: A failed program stays in the registry until its users release it, it is never drawn
+    try {
+        FinishProgram(entry.build);
+    } catch (const std::runtime_error&) {
+        entry.failed = true;
+        throw;
+    }
+    // Block bindings are not part of a program binary, bind after loading
+    CameraUniformBuffer::bindBlock(program);
+
+    entry.linked = true;
+}
+
+void ProgramRegistry::release(GLuint program) {
+    auto it = programs.find(program);
+    if (it == programs.end()) {
+        std::cerr << "Released program " << program << " is not in the registry" << std::endl;
+        return;
+    }
+
+    if (--it->second.references > 0) return;
+
+    // Shaders of a program that never finished are still alive
+    ProgramBuild build = it->second.build;
+    glDeleteShader(build.vertexShader);
+    glDeleteShader(build.fragmentShader);
+
+    programIds.erase(it->second.key);
+    programs.erase(it);
+    GLState::instance().deleteProgram(program);
+}
+
+std::unordered_map<std::string, UniformInfo>& ProgramRegistry::uniforms(GLuint program) {
+    auto it = programs.find(program);
+    if (it == programs.end()) {
+        std::cerr << "Uniforms of program " << program << " requested, it is not in the registry" << std::endl;
+        throw std::runtime_error("Program not in the registry");
+    }
+
+    return it->second.uniforms;
+}
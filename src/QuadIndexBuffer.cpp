@@ -0,0 +1,79 @@
+#include "QuadIndexBuffer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+template <typename Index>
+std::vector<Index> BuildQuadIndices(size_t quads) {
+    std::vector<Index> indices(quads * 6);
+
+    for (size_t k = 0; k < quads; k++) {
+        Index first = (Index)(4 * k);
+        indices[k * 6] = first;
+        indices[k * 6 + 1] = first + 1;
+        indices[k * 6 + 2] = first + 2;
+        indices[k * 6 + 3] = first;
+        indices[k * 6 + 4] = first + 2;
+        indices[k * 6 + 5] = first + 3;
+    }
+
+    return indices;
+}
+
+}  // namespace
+
+QuadIndexBuffer& QuadIndexBuffer::instance() {
+    static QuadIndexBuffer buffer;
+    return buffer;
+}
+
+void QuadIndexBuffer::bind(size_t quads) {
+    if (bufferId == 0) glGenBuffers(1, &bufferId);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bufferId);
+
+    if (quads > capacity) grow(quads);
+}
+
+GLenum QuadIndexBuffer::indexType() const {
+    return wideIndices ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+}
+
+const void* QuadIndexBuffer::quadOffset(size_t quad) const {
+    return (const void*)(quad * 6 * (wideIndices ? sizeof(uint32_t) : sizeof(uint16_t)));
+}
+
+size_t QuadIndexBuffer::quadCapacity() const {
+    return capacity;
+}
+
+void QuadIndexBuffer::release() {
+    if (bufferId != 0) glDeleteBuffers(1, &bufferId);
+
+    bufferId = 0;
+    capacity = 0;
+    wideIndices = false;
+}
+
+// NOTE: Expects the buffer to be bound to GL_ELEMENT_ARRAY_BUFFER
+void QuadIndexBuffer::grow(size_t quads) {
+    size_t newCapacity = std::max<size_t>({ quads, capacity * 2, 256 });
+
+    // Don't switch to 32-bit indices only because of the geometric growth
+    if ((quads <= QUAD_INDEX_MAX_16BIT_QUADS) && (newCapacity > QUAD_INDEX_MAX_16BIT_QUADS)) newCapacity = QUAD_INDEX_MAX_16BIT_QUADS;
+
+    wideIndices = (newCapacity > QUAD_INDEX_MAX_16BIT_QUADS);
+
+    if (wideIndices) {
+        std::vector<uint32_t> indices = BuildQuadIndices<uint32_t>(newCapacity);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indices.size() * sizeof(uint32_t)), indices.data(), GL_STATIC_DRAW);
+    } else {
+        std::vector<uint16_t> indices = BuildQuadIndices<uint16_t>(newCapacity);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indices.size() * sizeof(uint16_t)), indices.data(), GL_STATIC_DRAW);
+    }
+
+    capacity = newCapacity;
+}
@@ -6,43 +6,14 @@
 #include <iostream>
 #include <list>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
-// #include "renderer/gl/UniformUtils.hpp"
-
-void CheckCompilationErrors(GLuint shaderId, GLenum shaderType) {
-    GLint success;
-    glGetShaderiv(shaderId, GL_COMPILE_STATUS, &success);
-    GLchar infoLog[512];
-    glGetShaderInfoLog(shaderId, sizeof(infoLog), nullptr, infoLog);
-    if (!success) {
-        std::cerr << "Error compiling " << (shaderType == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader:"
-                  << infoLog << std::endl;
-        throw std::runtime_error("Shader compilation failed");
-    }
-}
 
-inline unsigned int createShader(int shaderType, const char* sourceCode) {
-    if (glCreateShader == nullptr) {
-        std::cout << "glCreateShader is a nullptr: " << glCreateShader
-                  << std::endl;
-    }
-
-    GLuint shaderId = glCreateShader(shaderType);
-    GLenum error = glGetError();
-    if (error != GL_NO_ERROR) {
-        std::cerr << "Program.cpp OpenGL error: " << error << std::endl;
-        // Handle the error as needed
-    }
-
-    glShaderSource(shaderId, 1, &sourceCode, nullptr);
-    glCompileShader(shaderId);
-
-    // Check for compilation errors
-    CheckCompilationErrors(shaderId, shaderType);
-
-    return shaderId;
-}
+#include "GLDebug.hpp"
+#include "GLState.hpp"
+#include "ProgramRegistry.hpp"
+// #include "renderer/gl/UniformUtils.hpp"
 
 std::unordered_map<std::string, GLint> fetchAttributeLocations(GLuint program) {
     std::unordered_map<std::string, GLint> attributes;
@@ -72,36 +43,22 @@ Shader::Shader(const std::string& vertexShaderPath, const std::string& fragmentS
 }
 
 void Shader::createProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath) {
-    // Read shader source code from files
-    std::string vertexGlsl = ReadShaderFile(vertexShaderPath);
-    std::string fragmentGlsl = ReadShaderFile(fragmentShaderPath);
-
-    // Compile shaders
-    const auto glVertexShader = createShader(GL_VERTEX_SHADER, vertexGlsl.c_str());
-    const auto glFragmentShader = createShader(GL_FRAGMENT_SHADER, fragmentGlsl.c_str());
-
-    this->program = glCreateProgram();
-    glAttachShader(program, glVertexShader);
-    glAttachShader(program, glFragmentShader);
-
-    glLinkProgram(program);
-
-    glDeleteShader(glVertexShader);
-    glDeleteShader(glFragmentShader);
+    // Shaders built from the same files share the program
+    this->program = ProgramRegistry::instance().acquire(vertexShaderPath, fragmentShaderPath);
+    // NOTE: Uniforms and attributes are reflected right after, the link has to finish here
+    try {
+        ProgramRegistry::instance().wait(program);
+    } catch (const std::runtime_error&) {
+        // The destructor doesn't run for a failed constructor, drop the reference here
+        ProgramRegistry::instance().release(program);
+        this->program = 0;
+        throw;
+    }
 }
 
 std::string Shader::ReadShaderFile(const std::string& filePath) const {
-    std::ifstream shaderFile(filePath);
-    if (!shaderFile.is_open()) {
-        std::cerr << "Error reading shader file: " << filePath << std::endl;
-        throw std::runtime_error("Failed to read shader file");
-    }
-
-    std::stringstream shaderStream;
-    shaderStream << shaderFile.rdbuf();
-    shaderFile.close();
-
-    return shaderStream.str();
+    // #include directives resolved, the same source the program is compiled from
+    return PreprocessShader(filePath);
 }
 
 // vertexSize is size of point(Vector2, Vector3, etc...) = 2, 3, etc...
@@ -112,12 +69,12 @@ void Shader::createBuffer(std::string attributeName, std::vector<float> vertexDa
     glGenBuffers(1, &VBO);
 
     // Upload vertex data
-    glBindVertexArray(VAO);
+    GLState::instance().bindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(GL_FLOAT), vertexData.data(), usage);
     glEnableVertexAttribArray(attributeLocation);
     glVertexAttribPointer(attributeLocation, vertexSize, GL_FLOAT, GL_FALSE, stride, (GLvoid*)offset);
-    glBindVertexArray(0);
+    GLState::instance().bindVertexArray(0);
 }
 
 std::unordered_map<std::string, int> Shader::getAttributes() {
@@ -129,7 +86,9 @@ std::unordered_map<std::string, int> Shader::getAttributes() {
 }
 
 std::unordered_map<std::string, UniformInfo> Shader::getUniforms() {
-    if (uniformMap.empty()) {
+    // NOTE: The program may be shared, its uniforms (and their shadow values) are reflected once
+    std::unordered_map<std::string, UniformInfo>& sharedUniforms = ProgramRegistry::instance().uniforms(program);
+    if (sharedUniforms.empty()) {
         int numUniforms;
         glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &numUniforms);
 
@@ -150,90 +109,42 @@ std::unordered_map<std::string, UniformInfo> Shader::getUniforms() {
             info.name = name;
             info.size = size;
             info.location = glGetUniformLocation(program, name.c_str());
+            info.shadow = std::make_shared<UniformShadow>();
 
-            uniformMap[name] = info;
+            sharedUniforms[name] = info;
         }
     }
+    uniformMap = sharedUniforms;
 
     return uniformMap;
 }
 
 void Shader::set_glUniform1f(const std::string& uniformName, const float& newValue) {
-    auto it = uniformMap.find(uniformName);
-
-    if (it != uniformMap.end()) {
-        // Uniform found in the map
-        UniformInfo& info = it->second;
-        glUniform1f(info.location, newValue);
-        // Check for OpenGL errors
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            // Handle error (print error message, log, etc.)
-            std::cerr << "OpenGL error after setting glUniform1f variable: " << error << std::endl;
-        }
-    } else {
-        // Uniform not found in the map
-        std::cout << "Uniform '" << uniformName << "' not found in the map." << std::endl;
-    }
+    uniform<float>(uniformName).set(newValue);
 }
 
 void Shader::set_glUniform3f(const std::string& uniformName, const Color& newValue) {
-    auto it = uniformMap.find(uniformName);
-
-    if (it != uniformMap.end()) {
-        // Uniform found in the map
-        UniformInfo& info = it->second;
-        glUniform3f(info.location, newValue.r, newValue.g, newValue.b);
-    } else {
-        // Uniform not found in the map
-        std::cout << "Uniform '" << uniformName << "' not found in the map." << std::endl;
-    }
+    uniform<Color>(uniformName).set(newValue);
 }
 
 void Shader::set_glUniformMatrix3fv(const std::string& uniformName, const Matrix3& newValue) {
-    auto it = uniformMap.find(uniformName);
-
-    if (it != uniformMap.end()) {
-        // Uniform found in the map
-        UniformInfo& info = it->second;
-        glUniformMatrix3fv(info.location, 1, false, newValue.elements.data());
-    } else {
-        // Uniform not found in the map
-        std::cout << "Uniform '" << uniformName << "' not found in the map." << std::endl;
-    }
+    uniform<Matrix3>(uniformName).set(newValue);
 }
 
-void Shader::set_glUniformMatrix4fv(const std::string& uniformName, const Matrix4 newValue) {
-    glUseProgram(program);
-    auto it = uniformMap.find(uniformName);
-
-    if (it != uniformMap.end()) {
-        // Uniform found in the map
-        UniformInfo& info = it->second;
-        glUniformMatrix4fv(info.location, 1, false, newValue.elements.data());
-        // Check for OpenGL errors
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            // Handle error (print error message, log, etc.)
-            std::cerr << "OpenGL error after setting UniformMatrix4fv variable: " << error << std::endl;
-        }
-    } else {
-        // Uniform not found in the map
-        std::cout << "Uniform '" << uniformName << "' not found in the map." << std::endl;
-    }
+void Shader::set_glUniformMatrix4fv(const std::string& uniformName, const Matrix4& newValue) {
+    uniform<Matrix4>(uniformName).set(newValue);
 }
 
 // Use the shader program
 void Shader::Use() const {
-    glUseProgram(program);
+    GLState::instance().useProgram(program);
 }
 
 void Shader::render(unsigned int mode_, int start, int count) {
-    glUseProgram(program);
-    glBindVertexArray(VAO);
+    GLState::instance().useProgram(program);
+    GLState::instance().bindVertexArray(VAO);
+    GL_DEBUG_MARK();
     glDrawArrays(mode_, start, count);
-    glBindVertexArray(0);
-    glUseProgram(0);
 }
 
 void Shader::renderIndexAttribute(int start, int count) {
@@ -242,6 +153,6 @@ void Shader::renderIndexAttribute(int start, int count) {
 }
 
 void Shader::destroy() {
-    glDeleteProgram(program);
+    ProgramRegistry::instance().release(program);
     this->program = -1;
 }
@@ -0,0 +1,145 @@
+#include "ShaderPreprocessor.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct PreprocessState {
+    std::vector<std::string> files;   // Source string number -> file, in the order they were first met
+    std::vector<std::string> stack;   // Files being expanded, an include of one of them is recursive
+    std::string defines;              // #define lines of the variant
+    bool versionFound = false;
+};
+
+std::string ReadSourceFile(const std::string& filePath) {
+    std::ifstream shaderFile(filePath);
+    if (!shaderFile.is_open()) {
+        std::cerr << "Error reading shader file: " << filePath << std::endl;
+        throw std::runtime_error("Failed to read shader file");
+    }
+
+    std::stringstream shaderStream;
+    shaderStream << shaderFile.rdbuf();
+
+    return shaderStream.str();
+}
+
+bool StartsWithDirective(const std::string& line, const char* directive, size_t& end) {
+    size_t start = line.find_first_not_of(" \t");
+    if ((start == std::string::npos) || (line[start] != '#')) return false;
+
+    start = line.find_first_not_of(" \t", start + 1);
+    size_t length = strlen(directive);
+    if ((start == std::string::npos) || (line.compare(start, length, directive) != 0)) return false;
+
+    end = start + length;
+    return true;
+}
+
+void AppendLineDirective(std::string& output, int line, size_t sourceString) {
+    // NOTE: Since GLSL 330 the line following #line N is line N
+    output += "#line " + std::to_string(line) + " " + std::to_string(sourceString) + "\n";
+}
+
+void AppendFile(const std::filesystem::path& path, PreprocessState& state, std::string& output) {
+    std::string file = path.lexically_normal().string();
+    for (const std::string& expanding : state.stack) {
+        if (expanding == file) {
+            std::cerr << "Shader file includes itself: " << file << std::endl;
+            throw std::runtime_error("Recursive shader #include");
+        }
+    }
+
+    std::string source = ReadSourceFile(file);
+    size_t sourceString = state.files.size();
+    state.files.push_back(file);
+    state.stack.push_back(file);
+
+    std::istringstream lines(source);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        size_t end = 0;
+
+        if (StartsWithDirective(line, "version", end)) {
+            // Only the #version of the compiled file is kept, defines follow it
+            if (sourceString == 0) {
+                output += line + "\n";
+                output += state.defines;
+                AppendLineDirective(output, lineNumber + 1, sourceString);
+                state.versionFound = true;
+            } else {
+                output += "\n";
+            }
+            continue;
+        }
+
+        if (StartsWithDirective(line, "include", end)) {
+            size_t nameStart = line.find('"', end);
+            size_t nameEnd = (nameStart == std::string::npos) ? std::string::npos : line.find('"', nameStart + 1);
+            if (nameEnd == std::string::npos) {
+                std::cerr << "Malformed #include in " << file << ":" << lineNumber << ": " << line << std::endl;
+                throw std::runtime_error("Malformed shader #include");
+            }
+
+            std::filesystem::path includePath = (path.parent_path() / line.substr(nameStart + 1, nameEnd - nameStart - 1)).lexically_normal();
+            bool included = false;
+            for (const std::string& includedFile : state.files) included |= (includedFile == includePath.string());
+            // Files still being expanded are not skipped, AppendFile() reports the recursive include
+            for (const std::string& expanding : state.stack) included &= (expanding != includePath.string());
+
+            if (included) {
+                output += "\n";  // Keeps the line numbers
+            } else {
+                AppendLineDirective(output, 1, state.files.size());
+                AppendFile(includePath, state, output);
+                AppendLineDirective(output, lineNumber + 1, sourceString);
+            }
+            continue;
+        }
+
+        output += line + "\n";
+    }
+
+    state.stack.pop_back();
+}
+
+}  // namespace
+
+std::string ShaderDefinesKey(const ShaderDefines& defines) {
+    std::string key;
+    for (const auto& [name, value] : defines) key += value.empty() ? name + ";" : name + "=" + value + ";";
+
+    return key;
+}
+
+const std::string& PreprocessShader(const std::string& filePath, const ShaderDefines& defines) {
+    static std::unordered_map<std::string, std::string> variants;
+
+    std::string key = filePath + '\n' + ShaderDefinesKey(defines);
+    auto it = variants.find(key);
+    if (it != variants.end()) return it->second;
+
+    PreprocessState state;
+    for (const auto& [name, value] : defines) state.defines += value.empty() ? "#define " + name + "\n" : "#define " + name + " " + value + "\n";
+
+    std::string source;
+    AppendFile(filePath, state, source);
+    // NOTE: Without #version (GLSL 110) the defines go first
+    if (!state.versionFound && !defines.empty()) {
+        std::string header = state.defines;
+        AppendLineDirective(header, 1, 0);
+        source = header + source;
+    }
+
+    // Not cached when a file failed, a fixed file is read again
+    return variants.emplace(key, std::move(source)).first->second;
+}
@@ -11,8 +11,13 @@
 #include "gltext.h"
 
 //
+#include "CameraUniformBuffer.hpp"
 #include "Events/CameraEvents.hpp"
+#include "GLDebug.hpp"
+#include "GLState.hpp"
 #include "Label/LabelShader.hpp"
+#include "ProgramCache.hpp"
+#include "QuadIndexBuffer.hpp"
 #include "Shader.hpp"
 #include "cameras/PerspectiveCamera.hpp"
 #include "filepath.hpp"
@@ -36,9 +41,15 @@ int main(int, char**) {
         return -1;
     }
 
-    glEnable(GL_CULL_FACE);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    // Asynchronous error reporting, does nothing unless built with GRAPHICS_GL_DEBUG
+    InstallGLDebugOutput(glfwGetProcAddress);
+    // Programs compile on driver threads, labels are drawn once their program is linked
+    InstallParallelShaderCompile(glfwGetProcAddress);
+
+    GLState& glState = GLState::instance();
+    glState.enable(GL_CULL_FACE);
+    glState.enable(GL_BLEND);
+    glState.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     GLFWmonitor* monitor = glfwGetPrimaryMonitor();
     const GLFWvidmode* mode = glfwGetVideoMode(monitor);
@@ -76,8 +87,6 @@ int main(int, char**) {
 
     // create buffer for triangle
     shader.createBuffer("position", vertices, GL_STATIC_DRAW, 3, 0, 0);
-    shader.set_glUniformMatrix4fv("projection", camera->projectionMatrix);  // setup shader projection matrix
-    glUseProgram(0);
 
     // SETUP TEXT SHADER
     std::string relativeFontPath = "fonts/anonymous_pro_bold.ttf";
@@ -94,8 +103,6 @@ int main(int, char**) {
 
     Color labelColor{ 1.0, 1.0, 0.0 };
     graphics::LabelShader textShader("}()?;&*+-/[]@#$%'\"^~:_=.\n this is a new line", *absoluteTextVertexShaderPath, *absoluteTextFragmentShaderPath, *absoluteFontPath, labelColor);
-    textShader.set_glUniformMatrix4fv("projection", camera->projectionMatrix);  // setup textShader projection matrix
-    glUseProgram(0);
 
     // TEXT FOR CAMERA INFO UPDATE
     // Initialize glText
@@ -104,12 +111,15 @@ int main(int, char**) {
         glfwTerminate();
         return EXIT_FAILURE;
     }
+    glState.invalidate();  // glText changes GL state behind GLState
     // Creating text
     GLTtext* text = gltCreateText();
 
     int viewportWidth, viewportHeight;
     double time;
 
+    CameraUniformBuffer& cameraUniforms = CameraUniformBuffer::instance();
+
     std::ostringstream cameraLog;
     // textShader.rotateX(180.0f);
     //   textShader.translateY(-2.0f);
@@ -120,6 +130,7 @@ int main(int, char**) {
     while (!glfwWindowShouldClose(window)) {
         glfwPollEvents();
         time = glfwGetTime();
+        glState.beginFrame();
 
         glfwGetFramebufferSize(window, &viewportWidth, &viewportHeight);
         glViewport(0, 0, viewportWidth, viewportHeight);
@@ -148,15 +159,11 @@ int main(int, char**) {
         // update camera matrices and frustum
         textShader.updateMatrixWorld();
         if (camera->parent == nullptr) camera->updateMatrixWorld();
-        shader.set_glUniformMatrix4fv("modelView", camera->matrixWorldInverse);
-        glUseProgram(0);
+        // view and projection of every program, uploaded only when the camera moved
+        cameraUniforms.update(*camera);
 
         // textShader.matrixWorld->lookAt(textShader.position, camera->position, { 0.0, 1.0, 0.0 });
         // textShader.matrixWorld->makeRotationX(180.0f);
-        textShader.modelViewMatrix.multiplyMatrices(camera->matrixWorldInverse, *textShader.matrixWorld);
-        textShader.normalMatrix.getNormalMatrix(textShader.modelViewMatrix);
-        textShader.set_glUniformMatrix4fv("modelView", textShader.modelViewMatrix);
-        glUseProgram(0);
 
         // rendering goes here
         // shader.render(GL_TRIANGLES, 0, 3);
@@ -165,6 +172,7 @@ int main(int, char**) {
         gltBeginDraw();
         // update camera position display
         cameraLog << "Camera x: " << camera->position.x << " Camera y: " << camera->position.y << " Camera z: " << camera->position.z;
+        cameraLog << "\nGL calls: " << glState.lastFrameStats().issuedCalls << " (" << glState.lastFrameStats().elidedCalls << " redundant skipped)";
 
         gltSetText(text, cameraLog.str().c_str());
 
@@ -178,12 +186,16 @@ int main(int, char**) {
         gltDrawText2DAligned(text, 0.0f, (GLfloat)viewportHeight, 2.0f, GLT_LEFT, GLT_BOTTOM);
 
         gltEndDraw();
+        // glText only binds its program, vertex array and the unit 0 texture
+        glState.invalidateBindings(GL_TEXTURE0);
 
         glfwSwapBuffers(window);
     }
 
     gltDeleteText(text);
     gltTerminate();
+    QuadIndexBuffer::instance().release();
+    cameraUniforms.release();
 
     glfwDestroyWindow(window);
     glfwTerminate();
@@ -0,0 +1,272 @@
+#include "Label/FontCache.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+
+#include "Hash.hpp"
+
+namespace {
+
+// On-disk layout: FontCacheHeader | FontCacheGlyph[glyphCount] | atlas pixel data
+struct FontCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t keyHash;
+    uint64_t fileHash;
+    int32_t baseSize;
+    int32_t fontType;
+    int32_t sdfPadding;
+    int32_t sdfOnEdgeValue;
+    float sdfDistScale;
+    int32_t sdfSupersample;
+    int32_t fontEngine;
+    int32_t atlasCompression;
+    int32_t glyphPadding;
+    int32_t packMethod;
+    int32_t glyphCount;
+    int32_t atlasWidth;
+    int32_t atlasHeight;
+    int32_t atlasFormat;
+    int32_t atlasMipmaps;
+    uint64_t atlasDataSize;
+};
+
+struct FontCacheGlyph {
+    int32_t value;
+    int32_t offsetX;
+    int32_t offsetY;
+    int32_t advanceX;
+    float x;
+    float y;
+    float width;
+    float height;
+};
+
+const char FONT_CACHE_MAGIC[4] = { 'F', 'S', 'D', 'F' };
+
+// Total size in bytes of an image including all of its mipmap levels
+uint64_t GetImageDataSize(int width, int height, int format, int mipmaps) {
+    uint64_t dataSize = 0;
+
+    for (int i = 0; i < mipmaps; i++) {
+        dataSize += rlGetPixelDataSize(width, height, format);
+        width = (width / 2 > 1) ? width / 2 : 1;
+        height = (height / 2 > 1) ? height / 2 : 1;
+    }
+
+    return dataSize;
+}
+
+const FontCacheHeader* GetHeader(const MappedFile& file) {
+    return reinterpret_cast<const FontCacheHeader*>(file.data());
+}
+
+}  // namespace
+
+uint64_t FontCacheKey::hash() const {
+    uint64_t result = HashBytes(&fileHash, sizeof(fileHash));
+    result = HashBytes(&baseSize, sizeof(baseSize), result);
+    result = HashBytes(&fontType, sizeof(fontType), result);
+    result = HashBytes(&sdfPadding, sizeof(sdfPadding), result);
+    result = HashBytes(&sdfOnEdgeValue, sizeof(sdfOnEdgeValue), result);
+    result = HashBytes(&sdfDistScale, sizeof(sdfDistScale), result);
+    result = HashBytes(&sdfSupersample, sizeof(sdfSupersample), result);
+    result = HashBytes(&fontEngine, sizeof(fontEngine), result);
+    result = HashBytes(&atlasCompression, sizeof(atlasCompression), result);
+    result = HashBytes(&glyphPadding, sizeof(glyphPadding), result);
+    result = HashBytes(&packMethod, sizeof(packMethod), result);
+    result = HashBytes(codepoints.data(), codepoints.size() * sizeof(int), result);
+
+    return result;
+}
+
+FontCacheKey MakeFontCacheKey(const unsigned char* fileData, int dataSize, int fontSize, int type, const int* codepoints, int codepointCount, int glyphPadding, int packMethod) {
+    FontCacheKey key;
+    key.fileHash = HashBytes(fileData, dataSize);
+    key.baseSize = fontSize;
+    key.fontType = type;
+    key.sdfPadding = FONT_SDF_CHAR_PADDING;
+    key.sdfOnEdgeValue = FONT_SDF_ON_EDGE_VALUE;
+    key.sdfDistScale = FONT_SDF_PIXEL_DIST_SCALE;
+    key.sdfSupersample = FONT_SDF_SUPERSAMPLE;
+#ifdef GRAPHICS_FREETYPE
+    key.fontEngine = 1;
+#endif
+    key.atlasCompression = FONT_ATLAS_COMPRESSION;
+    key.glyphPadding = glyphPadding;
+    key.packMethod = packMethod;
+
+    // Same defaults as LoadFontData(): 95 consecutive codepoints starting at 32 (Space)
+    codepointCount = (codepointCount > 0) ? codepointCount : 95;
+    key.codepoints.resize(codepointCount);
+    for (int i = 0; i < codepointCount; i++) key.codepoints[i] = (codepoints != NULL) ? codepoints[i] : i + 32;
+
+    return key;
+}
+
+std::string GetFontCachePath(const std::string& fontPath, const FontCacheKey& key) {
+    std::filesystem::path path(fontPath);
+
+    std::ostringstream fileName;
+    fileName << path.stem().string() << "_" << std::hex << std::setw(16) << std::setfill('0') << key.hash() << ".fontcache";
+
+    return (path.parent_path() / "cache" / fileName.str()).string();
+}
+
+bool FontCacheFile::open(const std::string& cachePath, const FontCacheKey& key) {
+    if (!file_.open(cachePath)) return false;
+
+    if (file_.size() < sizeof(FontCacheHeader)) {
+        TRACELOG(LOG_WARNING, "FONT: [%s] Cache file is truncated", cachePath.c_str());
+        close();
+        return false;
+    }
+
+    const FontCacheHeader* header = GetHeader(file_);
+    uint64_t glyphsSize = (uint64_t)key.codepoints.size() * sizeof(FontCacheGlyph);
+
+    bool valid = (memcmp(header->magic, FONT_CACHE_MAGIC, sizeof(FONT_CACHE_MAGIC)) == 0) &&
+                 (header->version == FONT_CACHE_VERSION) &&
+                 (header->keyHash == key.hash()) &&
+                 (header->fileHash == key.fileHash) &&
+                 (header->baseSize == key.baseSize) &&
+                 (header->fontType == key.fontType) &&
+                 (header->sdfPadding == key.sdfPadding) &&
+                 (header->sdfOnEdgeValue == key.sdfOnEdgeValue) &&
+                 (header->sdfDistScale == key.sdfDistScale) &&
+                 (header->sdfSupersample == key.sdfSupersample) &&
+                 (header->fontEngine == key.fontEngine) &&
+                 (header->atlasCompression == key.atlasCompression) &&
+                 (header->glyphPadding == key.glyphPadding) &&
+                 (header->packMethod == key.packMethod) &&
+                 (header->glyphCount == (int32_t)key.codepoints.size()) &&
+                 (header->atlasDataSize == GetImageDataSize(header->atlasWidth, header->atlasHeight, header->atlasFormat, header->atlasMipmaps)) &&
+                 (file_.size() == sizeof(FontCacheHeader) + glyphsSize + header->atlasDataSize);
+
+    // Codepoint set must match in the same order, glyph indices are used all over the text layout
+    for (int i = 0; valid && (i < header->glyphCount); i++) {
+        FontCacheGlyph glyph;
+        memcpy(&glyph, file_.data() + sizeof(FontCacheHeader) + i * sizeof(FontCacheGlyph), sizeof(glyph));
+        if (glyph.value != key.codepoints[i]) valid = false;
+    }
+
+    if (!valid) {
+        TRACELOG(LOG_INFO, "FONT: [%s] Cache file is stale, regenerating glyphs", cachePath.c_str());
+        close();
+        return false;
+    }
+
+    TRACELOG(LOG_INFO, "FONT: [%s] Glyph atlas loaded from cache", cachePath.c_str());
+
+    return true;
+}
+
+void FontCacheFile::close() {
+    file_.close();
+}
+
+int FontCacheFile::glyphCount() const {
+    return file_.isOpen() ? GetHeader(file_)->glyphCount : 0;
+}
+
+void FontCacheFile::loadGlyphs(GlyphInfo** glyphs, Rectangle** recs) const {
+    int count = glyphCount();
+
+    *glyphs = (GlyphInfo*)calloc(count, sizeof(GlyphInfo));
+    *recs = (Rectangle*)malloc(count * sizeof(Rectangle));
+
+    for (int i = 0; i < count; i++) {
+        FontCacheGlyph glyph;
+        memcpy(&glyph, file_.data() + sizeof(FontCacheHeader) + i * sizeof(FontCacheGlyph), sizeof(glyph));
+
+        (*glyphs)[i].value = glyph.value;
+        (*glyphs)[i].offsetX = glyph.offsetX;
+        (*glyphs)[i].offsetY = glyph.offsetY;
+        (*glyphs)[i].advanceX = glyph.advanceX;
+        (*recs)[i] = { glyph.x, glyph.y, glyph.width, glyph.height };
+    }
+}
+
+Image FontCacheFile::atlasImage() const {
+    Image atlas = { 0 };
+    if (!file_.isOpen()) return atlas;
+
+    const FontCacheHeader* header = GetHeader(file_);
+
+    atlas.data = (void*)(file_.data() + sizeof(FontCacheHeader) + header->glyphCount * sizeof(FontCacheGlyph));
+    atlas.width = header->atlasWidth;
+    atlas.height = header->atlasHeight;
+    atlas.mipmaps = header->atlasMipmaps;
+    atlas.format = header->atlasFormat;
+
+    return atlas;
+}
+
+bool SaveFontCache(const std::string& cachePath, const FontCacheKey& key, const GlyphInfo* glyphs, const Rectangle* recs, int glyphCount, Image atlas) {
+    if ((glyphs == NULL) || (recs == NULL) || (atlas.data == NULL) || (glyphCount != (int)key.codepoints.size())) return false;
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+
+    FontCacheHeader header = { 0 };
+    memcpy(header.magic, FONT_CACHE_MAGIC, sizeof(FONT_CACHE_MAGIC));
+    header.version = FONT_CACHE_VERSION;
+    header.keyHash = key.hash();
+    header.fileHash = key.fileHash;
+    header.baseSize = key.baseSize;
+    header.fontType = key.fontType;
+    header.sdfPadding = key.sdfPadding;
+    header.sdfOnEdgeValue = key.sdfOnEdgeValue;
+    header.sdfDistScale = key.sdfDistScale;
+    header.sdfSupersample = key.sdfSupersample;
+    header.fontEngine = key.fontEngine;
+    header.atlasCompression = key.atlasCompression;
+    header.glyphPadding = key.glyphPadding;
+    header.packMethod = key.packMethod;
+    header.glyphCount = glyphCount;
+    header.atlasWidth = atlas.width;
+    header.atlasHeight = atlas.height;
+    header.atlasFormat = atlas.format;
+    header.atlasMipmaps = atlas.mipmaps;
+    header.atlasDataSize = GetImageDataSize(atlas.width, atlas.height, atlas.format, atlas.mipmaps);
+
+    // Write to a temporary file first so a crash never leaves a half written cache behind
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream cacheFile(tempPath, std::ios::binary | std::ios::trunc);
+        if (!cacheFile.is_open()) {
+            TRACELOG(LOG_WARNING, "FONT: [%s] Failed to create cache file", cachePath.c_str());
+            return false;
+        }
+
+        cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        for (int i = 0; i < glyphCount; i++) {
+            FontCacheGlyph glyph = { glyphs[i].value, glyphs[i].offsetX, glyphs[i].offsetY, glyphs[i].advanceX,
+                                     recs[i].x, recs[i].y, recs[i].width, recs[i].height };
+            cacheFile.write(reinterpret_cast<const char*>(&glyph), sizeof(glyph));
+        }
+
+        cacheFile.write(static_cast<const char*>(atlas.data), (std::streamsize)header.atlasDataSize);
+
+        if (!cacheFile.good()) {
+            cacheFile.close();
+            std::filesystem::remove(tempPath, error);
+            TRACELOG(LOG_WARNING, "FONT: [%s] Failed to write cache file", cachePath.c_str());
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        TRACELOG(LOG_WARNING, "FONT: [%s] Failed to store cache file", cachePath.c_str());
+        return false;
+    }
+
+    return true;
+}
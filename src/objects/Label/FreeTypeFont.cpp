@@ -0,0 +1,190 @@
+#include "Label/FreeTypeFont.hpp"
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_ADVANCES_H
+#include FT_CACHE_H
+#include FT_MODULE_H
+#include FT_SIZES_H
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+FT_Error RequestFace(FTC_FaceID faceId, FT_Library library, FT_Pointer requestData, FT_Face* face) {
+    const std::vector<unsigned char>* data = (const std::vector<unsigned char>*)faceId;
+
+    return FT_New_Memory_Face(library, data->data(), (FT_Long)data->size(), 0, face);
+}
+
+// Copies an 8-bit bitmap into a newly allocated image, surrounded by padding pixels set to 0
+// NOTE: A negative pitch is a bottom-up bitmap, buffer starts with the last row
+unsigned char* CopyBitmap(const unsigned char* buffer, int width, int height, int pitch, int padding) {
+    int paddedWidth = width + 2 * padding;
+    unsigned char* data = (unsigned char*)calloc(paddedWidth * (height + 2 * padding), 1);
+    int rowSize = abs(pitch);
+
+    for (int y = 0; y < height; y++) {
+        int row = (pitch < 0) ? height - 1 - y : y;
+        memcpy(&data[(y + padding) * paddedWidth + padding], &buffer[row * rowSize], width);
+    }
+
+    return data;
+}
+
+}  // namespace
+
+FreeTypeFontEngine& FreeTypeFontEngine::instance() {
+    static FreeTypeFontEngine engine;
+    return engine;
+}
+
+FreeTypeFontEngine::FreeTypeFontEngine() {
+    if (FT_Init_FreeType(&library) != 0) {
+        TRACELOG(LOG_WARNING, "FONT: Failed to initialize FreeType");
+        library = nullptr;
+        return;
+    }
+
+    // The sdf renderer maps [-spread, spread] pixels to [0, 255], FONT_SDF_PIXEL_DIST_SCALE levels per pixel
+    FT_UInt spread = (FT_UInt)(128.0f / FONT_SDF_PIXEL_DIST_SCALE + 0.5f);
+    spread = (spread < 2) ? 2 : (spread > 32) ? 32 : spread;
+    FT_Property_Set(library, "sdf", "spread", &spread);
+
+    if ((FTC_Manager_New(library, FREETYPE_CACHE_MAX_FACES, FREETYPE_CACHE_MAX_SIZES, FREETYPE_CACHE_MAX_BYTES, RequestFace, NULL, &manager) != 0) ||
+        (FTC_SBitCache_New(manager, &sbitCache) != 0)) {
+        TRACELOG(LOG_WARNING, "FONT: Failed to create FreeType glyph cache");
+    }
+}
+
+FreeTypeFontEngine::~FreeTypeFontEngine() {
+    if (manager != nullptr) FTC_Manager_Done(manager);
+    if (library != nullptr) FT_Done_FreeType(library);
+}
+
+// Font files are compared by contents, a caller can free its copy and load the same font at another address
+void* FreeTypeFontEngine::getFaceId(const unsigned char* fileData, int dataSize) {
+    for (std::vector<unsigned char>& face : faces) {
+        if ((face.size() == (size_t)dataSize) && (memcmp(face.data(), fileData, dataSize) == 0)) return &face;
+    }
+
+    faces.emplace_back(fileData, fileData + dataSize);
+
+    return &faces.back();
+}
+
+GlyphInfo* FreeTypeFontEngine::loadFontData(const unsigned char* fileData, int dataSize, int fontSize, const int* codepoints, int codepointCount, int type) {
+    if ((fileData == NULL) || (sbitCache == nullptr)) return NULL;
+
+    FTC_FaceID faceId = getFaceId(fileData, dataSize);
+
+    FT_Face face = NULL;
+    if (FTC_Manager_LookupFace(manager, faceId, &face) != 0) {
+        TRACELOG(LOG_WARNING, "FONT: Failed to load font data with FreeType");
+        return NULL;
+    }
+
+    // Same scale as stbtt_ScaleForPixelHeight(): fontSize spans from ascender to descender
+    float scaleFactor = (float)fontSize / (float)(face->ascender - face->descender);
+    float emSize = scaleFactor * (float)face->units_per_EM;
+    int ascent = (int)((float)face->ascender * scaleFactor);
+
+    FTC_ScalerRec scaler = { 0 };
+    scaler.face_id = faceId;
+    scaler.width = (FT_UInt)(emSize * 64.0f + 0.5f);  // 26.6 character size, at 72 dpi a point is a pixel
+    scaler.height = scaler.width;
+    scaler.pixel = 0;
+    scaler.x_res = 72;
+    scaler.y_res = 72;
+
+    // Hinting is only applied to glyphs drawn at their base size, SDF glyphs are scaled
+    FT_ULong loadFlags = FT_LOAD_NO_BITMAP;
+    int padding = 0;
+
+    if (type == FONT_SDF) {
+        loadFlags |= FT_LOAD_NO_HINTING | FT_LOAD_TARGET_(FT_RENDER_MODE_SDF);
+
+        // The sdf renderer already pads the glyph with spread pixels
+        FT_UInt spread = 0;
+        FT_Property_Get(library, "sdf", "spread", &spread);
+        padding = (FONT_SDF_CHAR_PADDING > (int)spread) ? FONT_SDF_CHAR_PADDING - (int)spread : 0;
+    }
+
+    // In case no chars count provided, default to 95, filled consecutively starting at 32 (Space)
+    codepointCount = (codepointCount > 0) ? codepointCount : 95;
+
+    GlyphInfo* chars = (GlyphInfo*)calloc(codepointCount, sizeof(GlyphInfo));
+
+    for (int i = 0; i < codepointCount; i++) {
+        GlyphInfo* glyph = &chars[i];
+        int ch = (codepoints != NULL) ? codepoints[i] : i + 32;
+        glyph->value = ch;
+
+        // NOTE: Glyphs not found in the font are left empty, same as LoadFontData()
+        FT_UInt index = FT_Get_Char_Index(face, ch);
+        if (index == 0) continue;
+
+        FT_Fixed advance = 0;
+        FT_Get_Advance(face, index, FT_LOAD_NO_SCALE, &advance);
+        glyph->advanceX = (int)((float)advance * scaleFactor);
+
+        // NOTE: We create an empty image for space character, it could be further required for atlas packing
+        if (ch == 32) {
+            glyph->image.data = calloc(glyph->advanceX * fontSize, 2);
+            glyph->image.width = glyph->advanceX;
+            glyph->image.height = fontSize;
+            glyph->image.mipmaps = 1;
+            glyph->image.format = PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+            continue;
+        }
+
+        int width = 0, height = 0, left = 0, top = 0;
+
+        FTC_SBit sbit = NULL;
+        if (FTC_SBitCache_LookupScaler(sbitCache, &scaler, loadFlags, index, &sbit, NULL) != 0) continue;
+
+        if (sbit->buffer != NULL) {
+            if (sbit->format != FT_PIXEL_MODE_GRAY) continue;
+
+            width = sbit->width;
+            height = sbit->height;
+            left = sbit->left;
+            top = sbit->top;
+            glyph->image.data = CopyBitmap(sbit->buffer, width, height, sbit->pitch, padding);
+        } else {
+            // Not kept by the small bitmap cache (too big, or no outline), render it on the face from the manager
+            // NOTE: The face looked up above may have been flushed by the sbit lookup, look it up again
+            FT_Size size = NULL;
+            if ((FTC_Manager_LookupFace(manager, faceId, &face) != 0) || (FTC_Manager_LookupSize(manager, &scaler, &size) != 0) ||
+                (FT_Activate_Size(size) != 0))
+                continue;
+            if (FT_Load_Glyph(face, index, (FT_Int32)(loadFlags | FT_LOAD_RENDER)) != 0) continue;
+
+            const FT_Bitmap& bitmap = face->glyph->bitmap;
+            if ((bitmap.buffer == NULL) || (bitmap.pixel_mode != FT_PIXEL_MODE_GRAY)) continue;  // Glyph without outline
+
+            width = (int)bitmap.width;
+            height = (int)bitmap.rows;
+            left = face->glyph->bitmap_left;
+            top = face->glyph->bitmap_top;
+            glyph->image.data = CopyBitmap(bitmap.buffer, width, height, bitmap.pitch, padding);
+        }
+
+        glyph->image.width = width + 2 * padding;
+        glyph->image.height = height + 2 * padding;
+        glyph->image.mipmaps = 1;
+        glyph->image.format = PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+
+        glyph->offsetX = left - padding;
+        glyph->offsetY = ascent - top - padding;
+
+        if (type == FONT_BITMAP) {
+            // Aliased bitmap (black & white) font generation, avoiding anti-aliasing
+            unsigned char* pixels = (unsigned char*)glyph->image.data;
+            for (int p = 0; p < glyph->image.width * glyph->image.height; p++) pixels[p] = (pixels[p] < FONT_BITMAP_ALPHA_THRESHOLD) ? 0 : 255;
+        }
+    }
+
+    return chars;
+}
@@ -0,0 +1,308 @@
+#include "Label/GlyphAtlas.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "GLState.hpp"
+
+using namespace graphics;
+
+GlyphAtlas::GlyphAtlas(const std::string& fontPath, int fontSize, int fontType, int width, int height, int maxGlyphs)
+    : fontType(fontType), channels((fontType == FONT_MSDF) ? 3 : 1) {
+    fileData = LoadFileData(fontPath.c_str(), &fileSize);
+    kerningSource = LoadKerningSource(fileData, fileSize, fontSize);
+
+    font.baseSize = fontSize;
+    font.glyphCount = maxGlyphs;
+    font.glyphPadding = 0;
+    font.glyphs = (GlyphInfo*)calloc(maxGlyphs, sizeof(GlyphInfo));
+    font.recs = (Rectangle*)calloc(maxGlyphs, sizeof(Rectangle));
+    for (int i = 0; i < maxGlyphs; i++) font.glyphs[i].value = -1;
+
+    glyphSlots.resize(maxGlyphs);
+    // Lowest slots are handed out first
+    for (int i = maxGlyphs - 1; i >= 0; i--) freeSlots.emplace_back(i);
+
+    pixels.assign(width * height * channels, 0);
+
+    packContext = std::make_unique<stbrp_context>();
+    packNodes.resize(width);
+    raylib_stbrp_init_target(packContext.get(), width, height, packNodes.data(), (int)packNodes.size());
+
+    GLState::instance().bindTexture(GL_TEXTURE_2D, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glGenTextures(1, &font.texture.id);
+    GLState::instance().bindTexture(GL_TEXTURE_2D, font.texture.id);
+
+    if (channels == 3) {
+        // Distances to the edges of each color are sampled as rgb by msdf.frag
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+
+        // Single channel is sampled as alpha, same as the GenImageFontAtlas() atlas loaded by LabelShader
+        GLint swizzleMask[] = { GL_ONE, GL_ONE, GL_ONE, GL_RED };
+        glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    GLState::instance().bindTexture(GL_TEXTURE_2D, 0);
+
+    font.texture.width = width;
+    font.texture.height = height;
+    font.texture.mipmaps = 1;
+    font.texture.format = (channels == 3) ? PIXELFORMAT_UNCOMPRESSED_R8G8B8 : PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+
+    layoutCache = std::make_shared<TextLayoutCache>();
+
+    // Fallback glyph owns slot 0 and is never evicted, the slot stays empty when the font has no '?'
+    // so missing codepoints (mapped to slot 0) never draw as another glyph
+    freeSlots.pop_back();
+    int fallbackCodepoint = '?';
+    GlyphInfo* fallback = LoadFontData(fileData, fileSize, font.baseSize, &fallbackCodepoint, 1, fontType);
+    if ((fallback != NULL) && (fallback->image.data != NULL) && packGlyph(0, *fallback))
+        storeGlyph(0, '?', *fallback);
+    else
+        TRACELOG(LOG_WARNING, "FONT: [%s] Fallback glyph '?' not available for glyph atlas", fontPath.c_str());
+    if (fallback != NULL) free(fallback->image.data);
+    free(fallback);
+    flush();
+}
+
+GlyphAtlas::~GlyphAtlas() {
+    GLState::instance().deleteTexture(font.texture.id);
+    free(font.glyphs);
+    free(font.recs);
+    UnloadKerningSource(kerningSource);
+    free(fileData);
+}
+
+int GlyphAtlas::getGlyphIndex(int codepoint) {
+    int slot = codepointSlots.find(codepoint);
+
+    if (slot != -1) {
+        glyphSlots[slot].lastUsed = frame;
+        return slot;
+    }
+
+    return insertGlyph(codepoint);
+}
+
+void GlyphAtlas::touch(const std::vector<int>& slots) {
+    for (int slot : slots) glyphSlots[slot].lastUsed = frame;
+}
+
+void GlyphAtlas::beginFrame() {
+    frame++;
+}
+
+void GlyphAtlas::flush() {
+    if ((dirtyMinX >= dirtyMaxX) || (dirtyMinY >= dirtyMaxY)) return;
+
+    GLState::instance().bindTexture(GL_TEXTURE_2D, font.texture.id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, font.texture.width);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, dirtyMinX, dirtyMinY, dirtyMaxX - dirtyMinX, dirtyMaxY - dirtyMinY, (channels == 3) ? GL_RGB : GL_RED, GL_UNSIGNED_BYTE,
+                    pixels.data() + (dirtyMinY * font.texture.width + dirtyMinX) * channels);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    GLState::instance().bindTexture(GL_TEXTURE_2D, 0);
+
+    dirtyMinX = dirtyMinY = dirtyMaxX = dirtyMaxY = 0;
+}
+
+int GlyphAtlas::insertGlyph(int codepoint) {
+    GlyphInfo* glyph = LoadFontData(fileData, fileSize, font.baseSize, &codepoint, 1, fontType);
+
+    if ((glyph == NULL) || (glyph->image.data == NULL)) {
+        // Not available in the font, remember it so it is not rasterized again
+        free(glyph);
+        codepointSlots.set(codepoint, 0);
+        return 0;
+    }
+
+    int slot = acquireSlot();
+
+    if ((slot >= 0) && (packGlyph(slot, *glyph) || evictAndRepack(slot, *glyph))) {
+        storeGlyph(slot, codepoint, *glyph);
+    } else {
+        TRACELOG(LOG_WARNING, "FONT: Glyph atlas is full, failed to add character (%i)", codepoint);
+        if (slot >= 0) releaseSlot(slot);
+        slot = 0;
+    }
+
+    free(glyph->image.data);
+    free(glyph);
+
+    return slot;
+}
+
+void GlyphAtlas::storeGlyph(int slot, int codepoint, const GlyphInfo& glyph) {
+    font.glyphs[slot].value = codepoint;
+    font.glyphs[slot].offsetX = glyph.offsetX;
+    font.glyphs[slot].offsetY = glyph.offsetY;
+    font.glyphs[slot].advanceX = glyph.advanceX;
+    font.glyphs[slot].image = { 0 };  // Pixels only live in the atlas
+
+    glyphSlots[slot].codepoint = codepoint;
+    glyphSlots[slot].lastUsed = frame;
+    codepointSlots.set(codepoint, slot);
+    addKerning(codepoint);
+}
+
+int GlyphAtlas::acquireSlot() {
+    if (freeSlots.empty()) {
+        // Reuse the slot of the least recently used glyph, its atlas area is reclaimed on the next repack
+        int oldest = -1;
+        for (int i = 1; i < (int)glyphSlots.size(); i++) {
+            if (glyphSlots[i].codepoint == -1 || glyphSlots[i].lastUsed == frame) continue;
+            if ((oldest == -1) || (glyphSlots[i].lastUsed < glyphSlots[oldest].lastUsed)) oldest = i;
+        }
+
+        if (oldest == -1) return -1;
+
+        releaseSlot(oldest);
+        generation++;
+    }
+
+    int slot = freeSlots.back();
+    freeSlots.pop_back();
+
+    return slot;
+}
+
+bool GlyphAtlas::packGlyph(int slot, const GlyphInfo& glyph) {
+    stbrp_rect rect = { 0 };
+    rect.id = slot;
+    rect.w = glyph.image.width + 2 * padding;
+    rect.h = glyph.image.height + 2 * padding;
+
+    raylib_stbrp_pack_rects(packContext.get(), &rect, 1);
+    if (!rect.was_packed) return false;
+
+    font.recs[slot] = { (float)(rect.x + padding), (float)(rect.y + padding), (float)glyph.image.width, (float)glyph.image.height };
+    copyGlyphPixels(glyph, rect.x + padding, rect.y + padding);
+
+    return true;
+}
+
+// Evicts the least recently used glyphs (never the ones used on the current frame) until
+// the remaining glyphs plus the new one fit when packed again from scratch
+bool GlyphAtlas::evictAndRepack(int slot, const GlyphInfo& glyph) {
+    std::vector<int> candidates;
+    for (int i = 1; i < (int)glyphSlots.size(); i++) {
+        if ((i != slot) && (glyphSlots[i].codepoint != -1) && (glyphSlots[i].lastUsed != frame)) candidates.emplace_back(i);
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [this](int a, int b) { return glyphSlots[a].lastUsed < glyphSlots[b].lastUsed; });
+
+    // First attempt evicts nothing, it reclaims the area of slots reused by acquireSlot()
+    size_t evictCount = 0;
+    const size_t evictStep = std::max<size_t>(1, candidates.size() / 4);
+
+    for (;; evictCount = std::min(candidates.size(), evictCount + evictStep)) {
+        std::vector<bool> evicted(glyphSlots.size(), false);
+        for (size_t i = 0; i < evictCount; i++) evicted[candidates[i]] = true;
+
+        std::vector<stbrp_rect> rects;
+        for (int i = 0; i < (int)glyphSlots.size(); i++) {
+            if ((glyphSlots[i].codepoint == -1) || evicted[i]) continue;
+
+            stbrp_rect rect = { 0 };
+            rect.id = i;
+            rect.w = (int)font.recs[i].width + 2 * padding;
+            rect.h = (int)font.recs[i].height + 2 * padding;
+            rects.emplace_back(rect);
+        }
+
+        stbrp_rect newRect = { 0 };
+        newRect.id = slot;
+        newRect.w = glyph.image.width + 2 * padding;
+        newRect.h = glyph.image.height + 2 * padding;
+        rects.emplace_back(newRect);
+
+        auto context = std::make_unique<stbrp_context>();
+        std::vector<stbrp_node> nodes(font.texture.width);
+        raylib_stbrp_init_target(context.get(), font.texture.width, font.texture.height, nodes.data(), (int)nodes.size());
+
+        if (!raylib_stbrp_pack_rects(context.get(), rects.data(), (int)rects.size())) {
+            if (evictCount == candidates.size()) return false;
+            continue;
+        }
+
+        // Everything fits, move surviving glyphs to their new place
+        std::vector<unsigned char> repacked(pixels.size(), 0);
+        for (const stbrp_rect& rect : rects) {
+            if (rect.id == slot) continue;
+
+            Rectangle& rec = font.recs[rect.id];
+            for (int y = 0; y < (int)rec.height; y++) {
+                memcpy(&repacked[((rect.y + padding + y) * font.texture.width + rect.x + padding) * channels],
+                       &pixels[(((int)rec.y + y) * font.texture.width + (int)rec.x) * channels], (size_t)rec.width * channels);
+            }
+
+            rec.x = (float)(rect.x + padding);
+            rec.y = (float)(rect.y + padding);
+        }
+
+        for (size_t i = 0; i < evictCount; i++) releaseSlot(candidates[i]);
+
+        pixels.swap(repacked);
+        packContext.swap(context);
+        packNodes.swap(nodes);
+
+        for (const stbrp_rect& rect : rects) {
+            if (rect.id != slot) continue;
+
+            font.recs[slot] = { (float)(rect.x + padding), (float)(rect.y + padding), (float)glyph.image.width, (float)glyph.image.height };
+            copyGlyphPixels(glyph, rect.x + padding, rect.y + padding);
+        }
+
+        markDirty(0, 0, font.texture.width, font.texture.height);
+        generation++;
+
+        return true;
+    }
+}
+
+void GlyphAtlas::copyGlyphPixels(const GlyphInfo& glyph, int x, int y) {
+    for (int row = 0; row < glyph.image.height; row++) {
+        memcpy(&pixels[((y + row) * font.texture.width + x) * channels], (unsigned char*)glyph.image.data + row * glyph.image.width * channels,
+               glyph.image.width * channels);
+    }
+
+    markDirty(x, y, glyph.image.width, glyph.image.height);
+}
+
+void GlyphAtlas::markDirty(int x, int y, int width, int height) {
+    if ((dirtyMinX >= dirtyMaxX) || (dirtyMinY >= dirtyMaxY)) {
+        dirtyMinX = x;
+        dirtyMinY = y;
+        dirtyMaxX = x + width;
+        dirtyMaxY = y + height;
+    } else {
+        dirtyMinX = std::min(dirtyMinX, x);
+        dirtyMinY = std::min(dirtyMinY, y);
+        dirtyMaxX = std::max(dirtyMaxX, x + width);
+        dirtyMaxY = std::max(dirtyMaxY, y + height);
+    }
+}
+
+void GlyphAtlas::releaseSlot(int slot) {
+    if (glyphSlots[slot].codepoint != -1) codepointSlots.erase(glyphSlots[slot].codepoint);
+
+    glyphSlots[slot] = Slot();
+    font.glyphs[slot].value = -1;
+    font.recs[slot] = { 0 };
+    freeSlots.emplace_back(slot);
+}
+
+// Kerning of the new codepoint with every codepoint added before, both ways
+// NOTE: Pairs are kept after eviction, they only depend on the font, an evicted codepoint adds nothing
+void GlyphAtlas::addKerning(int codepoint) {
+    int pairCount = 0;
+    KerningPair* pairs = AddKerningCodepoint(kerningSource, codepoint, &pairCount);
+    layoutCache->kerning.add(pairs, pairCount);
+    free(pairs);
+}
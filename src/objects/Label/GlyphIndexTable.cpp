@@ -0,0 +1,126 @@
+#include "Label/GlyphIndexTable.hpp"
+
+namespace {
+
+// Spreads codepoints from the same block over the table (Murmur3 finalizer)
+uint32_t HashCodepoint(int codepoint) {
+    uint32_t hash = (uint32_t)codepoint;
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+}  // namespace
+
+void GlyphIndexTable::build(const Font& font) {
+    clear();
+
+    for (int i = 0; i < font.glyphCount; i++) {
+        // First glyph wins on duplicated codepoints, same as the linear scan
+        if (find(font.glyphs[i].value) == -1) set(font.glyphs[i].value, i);
+    }
+
+    int fallback = find('?');
+    fallbackIndex = (fallback != -1) ? fallback : 0;
+}
+
+void GlyphIndexTable::clear() {
+    direct.clear();
+    entries.clear();
+    used = 0;
+    fallbackIndex = 0;
+}
+
+int GlyphIndexTable::find(int codepoint) const {
+    if ((codepoint >= 0) && (codepoint < GLYPH_INDEX_DIRECT_RANGE)) {
+        return (codepoint < (int)direct.size()) ? direct[codepoint] : -1;
+    }
+
+    if (entries.empty() || (codepoint < 0)) return -1;
+
+    const Entry& entry = entries[findSlot(codepoint)];
+
+    return (entry.codepoint == codepoint) ? entry.index : -1;
+}
+
+int GlyphIndexTable::get(int codepoint) const {
+    int index = find(codepoint);
+
+    return (index != -1) ? index : fallbackIndex;
+}
+
+void GlyphIndexTable::set(int codepoint, int index) {
+    if (codepoint < 0) return;
+
+    if (codepoint < GLYPH_INDEX_DIRECT_RANGE) {
+        if (codepoint >= (int)direct.size()) direct.resize(codepoint + 1, -1);
+        direct[codepoint] = index;
+        return;
+    }
+
+    // Keep the load factor (tombstones included) under 1/2 so probe sequences stay short
+    if ((used + 1) * 2 > entries.size()) rehash((entries.size() < 16) ? 16 : entries.size() * 2);
+
+    size_t slot = findSlot(codepoint);
+    if (entries[slot].codepoint != codepoint) {
+        if (entries[slot].codepoint == EMPTY_KEY) used++;
+        entries[slot].codepoint = codepoint;
+    }
+
+    entries[slot].index = index;
+}
+
+void GlyphIndexTable::erase(int codepoint) {
+    if ((codepoint >= 0) && (codepoint < GLYPH_INDEX_DIRECT_RANGE)) {
+        if (codepoint < (int)direct.size()) direct[codepoint] = -1;
+        return;
+    }
+
+    if (entries.empty() || (codepoint < 0)) return;
+
+    size_t slot = findSlot(codepoint);
+    if (entries[slot].codepoint == codepoint) entries[slot].codepoint = TOMBSTONE_KEY;
+}
+
+// Slot holding codepoint, or the slot where it should be inserted (first tombstone on the probe sequence)
+size_t GlyphIndexTable::findSlot(int codepoint) const {
+    const size_t mask = entries.size() - 1;
+    size_t slot = HashCodepoint(codepoint) & mask;
+    size_t tombstone = entries.size();
+
+    while (entries[slot].codepoint != EMPTY_KEY) {
+        if (entries[slot].codepoint == codepoint) return slot;
+        if ((entries[slot].codepoint == TOMBSTONE_KEY) && (tombstone == entries.size())) tombstone = slot;
+
+        slot = (slot + 1) & mask;
+    }
+
+    return (tombstone != entries.size()) ? tombstone : slot;
+}
+
+void GlyphIndexTable::rehash(size_t capacity) {
+    std::vector<Entry> previous;
+    previous.swap(entries);
+
+    // Tombstones are dropped, only live entries are inserted again
+    size_t live = 0;
+    for (const Entry& entry : previous) {
+        if (entry.codepoint >= 0) live++;
+    }
+    while ((live + 1) * 2 > capacity) capacity *= 2;
+
+    entries.assign(capacity, { EMPTY_KEY, 0 });
+    used = 0;
+
+    for (const Entry& entry : previous) {
+        if (entry.codepoint < 0) continue;
+
+        size_t slot = findSlot(entry.codepoint);
+        entries[slot] = entry;
+        used++;
+    }
+}
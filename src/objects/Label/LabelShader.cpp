@@ -1,7 +1,10 @@
 
 #include "Label/LabelShader.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <list>
@@ -9,106 +12,44 @@
 #include <string>
 #include <vector>
 
+#include "GLDebug.hpp"
+#include "GLState.hpp"
+#include "Label/FontCache.hpp"
+#include "Label/Utf8.hpp"
 #include "Label/helpers.hpp"
+#include "ProgramRegistry.hpp"
+#include "QuadIndexBuffer.hpp"
+#include "ShaderLayouts.hpp"
 #include "math/MathUtils.hpp"
 #include "math/Vector2.hpp"
 #include "math/Vector3.hpp"
 
-void CheckCompilationErrors(GLuint shaderId, GLenum shaderType);
-inline unsigned int createShader(int shaderType, const char* sourceCode);
-std::unordered_map<std::string, GLint> fetchAttributeLocations(GLuint program);
-
-void print_opengl_error() {
-    GLenum error = glGetError();
-    if (error != GL_NO_ERROR) {
-        std::cerr << "OpenGL ERROR: " << error << std::endl;
-    }
-    if (error == GL_INVALID_ENUM) {
-        std::cerr << "GL_INVALID_ENUM: " << error << std::endl;
-    }
-    if (error == GL_INVALID_VALUE) {
-        std::cerr << "GL_INVALID_VALUE: " << error << std::endl;
-    }
-    if (error == GL_INVALID_OPERATION) {
-        std::cerr << "GL_INVALID_OPERATION: " << error << std::endl;
-    }
-    if (error == GL_INVALID_FRAMEBUFFER_OPERATION) {
-        std::cerr << "GL_INVALID_FRAMEBUFFER_OPERATION: " << error << std::endl;
-    }
-    if (error == GL_OUT_OF_MEMORY) {
-        std::cerr << "GL_OUT_OF_MEMORY: " << error << std::endl;
-    }
-    if (error == GL_STACK_UNDERFLOW) {
-        std::cerr << "GL_STACK_UNDERFLOW: " << error << std::endl;
-    }
-    if (error == GL_STACK_OVERFLOW) {
-        std::cerr << "GL_STACK_OVERFLOW: " << error << std::endl;
-    }
-}
-
 graphics::Vector2 graphics::LabelShader::MeasureTextEx(const char* text, float fontSize, float spacing) {
     graphics::Vector2 textSize = { 0, 0 };
 
     if ((font.texture.id == 0) || (text == NULL)) return textSize;
 
-    int size = TextLength(text);  // Get size in bytes of text
-    int tempByteCounter = 0;      // Used to count longer text line num chars
-    int byteCounter = 0;
-
-    float textWidth = 0.0f;
-    float tempTextWidth = 0.0f;  // Used to count longer text line width
-
-    float textHeight = fontSize;
+    const TextLayout& layout = getLayout(text);
     float scaleFactor = fontSize / (float)font.baseSize;
 
-    int letter = 0;  // Current character
-    int index = 0;   // Index position in sprite font
-
-    for (int i = 0; i < size;) {
-        byteCounter++;
-
-        int next = 0;
-        letter = GetCodepointNext(&text[i], &next);
-        index = GetGlyphIndex(font, letter);
-
-        i += next;
-
-        if (letter != '\n') {
-            if (font.glyphs[index].advanceX != 0)
-                textWidth += font.glyphs[index].advanceX;
-            else
-                textWidth += (font.recs[index].width + font.glyphs[index].offsetX);
-        } else {
-            if (tempTextWidth < textWidth) tempTextWidth = textWidth;
-            byteCounter = 0;
-            textWidth = 0;
-
-            // NOTE: Line spacing is a global variable, use SetTextLineSpacing() to setup
-            textHeight += (float)textLineSpacing;
-        }
-
-        if (tempByteCounter < byteCounter) tempByteCounter = byteCounter;
-    }
-
-    if (tempTextWidth < textWidth) tempTextWidth = textWidth;
-
-    textSize.x = tempTextWidth * scaleFactor + (float)((tempByteCounter - 1) * spacing);
-    textSize.y = textHeight;
+    textSize.x = layout.maxLineAdvance * scaleFactor + (float)((layout.maxLineCodepoints - 1) * spacing);
+    // NOTE: Line spacing is a global variable, use SetTextLineSpacing() to setup
+    textSize.y = fontSize + (float)((layout.lineCount - 1) * textLineSpacing);
 
     return textSize;
 }
 
-graphics::LabelShader::LabelShader(const char* labelName, const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const std::string& fontPath, const Color& textColor) {
+graphics::LabelShader::LabelShader(const char* labelName, const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const std::string& fontPath, const Color& textColor, LabelRenderMode mode,
+                                   int fontType) {
     labelText = labelName;
+    setRenderMode(mode);
+    glyphFontType = fontType;
     createProgram(vertexShaderPath, fragmentShaderPath);
-    init_font(fontPath);
-    // cache uniforms
-    getUniforms();
-    getAttributes();
+    init_font(fontPath, fontType);
     buildVertices({ 0.0f, 0.0f, 0.0f });  // create vertexData points and texture data
     // build buffers using vertexData
     createTextBuffer(GL_DYNAMIC_DRAW);  // previous: GL_STREAM_DRAW, can also be: GL_STATIC_DRAW
-    Use();
+    // NOTE: Uniforms are uploaded by render() once the program is linked
     set_shader_text_color(textColor);
     // rotateX(180.0f);
     //   graphics::Vector3 starting_position{ 0, 0, 0 };
@@ -116,49 +57,88 @@ graphics::LabelShader::LabelShader(const char* labelName, const std::string& ver
     //    starting_position.y = 10;
 }
 
-void graphics::LabelShader::createProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath) {
-    // Read shader source code from files
-    std::string vertexGlsl = ReadShaderFile(vertexShaderPath);
-    std::string fragmentGlsl = ReadShaderFile(fragmentShaderPath);
+graphics::LabelShader::LabelShader(const char* labelName, const std::string& vertexShaderPath, const std::string& fragmentShaderPath, std::shared_ptr<GlyphAtlas> atlas, const Color& textColor, LabelRenderMode mode) {
+    labelText = labelName;
+    setRenderMode(mode);
+    glyphFontType = atlas->getFontType();
+    createProgram(vertexShaderPath, fragmentShaderPath);
+    glyphAtlas = atlas;
+    font = glyphAtlas->font;  // NOTE: atlas glyph arrays are never reallocated, sharing the pointers is safe
+    texture = font.texture;
+    layoutCache = glyphAtlas->layoutCache;
+    // Glyphs added by the first layout can move the ones already placed, same loop as rebuildVertices()
+    do {
+        atlasGeneration = glyphAtlas->generation;
+        buildVertices({ 0.0f, 0.0f, 0.0f });
+    } while (atlasGeneration != glyphAtlas->generation);
+    createTextBuffer(GL_DYNAMIC_DRAW);
+    // NOTE: Uniforms are uploaded by render() once the program is linked
+    set_shader_text_color(textColor);
+}
 
-    // Compile shaders
-    const auto glVertexShader = createShader(GL_VERTEX_SHADER, vertexGlsl.c_str());
-    const auto glFragmentShader = createShader(GL_FRAGMENT_SHADER, fragmentGlsl.c_str());
+void graphics::LabelShader::setRenderMode(LabelRenderMode mode) {
+    // glVertexAttribDivisor is core since OpenGL 3.3, the window only asks for 3.2
+    if ((mode == LABEL_RENDER_INSTANCED) && (glVertexAttribDivisor == nullptr)) {
+        std::cerr << "Instanced text rendering requires glVertexAttribDivisor (OpenGL 3.3)" << std::endl;
+        throw std::runtime_error("Instanced text rendering not supported");
+    }
 
-    this->program = glCreateProgram();
-    glAttachShader(program, glVertexShader);
-    glAttachShader(program, glFragmentShader);
+    renderMode = mode;
+}
 
-    glLinkProgram(program);
+void graphics::LabelShader::createProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath) {
+    // Labels built from the same files share the program, render() sets the per label uniforms
+    // Vertex inputs get the locations generated from the shader sources, createTextBuffer() uses them directly
+    // NOTE: The vertex shader decides the render mode, text_instanced.vert is only used instanced
+    vertexShaderFile = vertexShaderPath;
+    fragmentShaderFile = fragmentShaderPath;
+    this->program = ProgramRegistry::instance().acquire(vertexShaderPath, fragmentShaderPath, shaderDefines(), [this](GLuint newProgram) {
+        if (renderMode == LABEL_RENDER_INSTANCED)
+            BindAttributeLocations<shaders::text_instanced_vert>(newProgram);
+        else
+            BindAttributeLocations<shaders::text_vert>(newProgram);
+    });
+}
 
-    glDeleteShader(glVertexShader);
-    glDeleteShader(glFragmentShader);
+ShaderDefines graphics::LabelShader::shaderDefines() const {
+    // Settings are compiled into the variant, the fragment shader has no branch on them
+    ShaderDefines defines;
+    if (billboard) defines["BILLBOARD"] = "";
+    if (glyphFontType == FONT_MSDF)
+        defines["MSDF"] = "";
+    else if ((glyphFontType == FONT_DEFAULT) || (glyphFontType == FONT_BITMAP))
+        defines["BITMAP"] = "";
+    // Instances carry a per glyph color multiplied by the label color
+    if (renderMode == LABEL_RENDER_INSTANCED) defines["VERTEX_COLOR"] = "";
+
+    return defines;
 }
 
-std::string LabelShader::ReadShaderFile(const std::string& filePath) const {
-    std::ifstream shaderFile(filePath);
-    if (!shaderFile.is_open()) {
-        std::cerr << "Error reading shader file: " << filePath << std::endl;
-        throw std::runtime_error("Failed to read shader file");
-    }
+void graphics::LabelShader::setBillboard(bool enabled) {
+    if (billboard == enabled) return;
 
-    std::stringstream shaderStream;
-    shaderStream << shaderFile.rdbuf();
-    shaderFile.close();
+    billboard = enabled;
+    // Attribute locations are the same in every variant, the VAO is kept
+    ProgramRegistry::instance().release(program);
+    createProgram(vertexShaderFile, fragmentShaderFile);
+    uniformsResolved = false;
+}
 
-    return shaderStream.str();
+std::string LabelShader::ReadShaderFile(const std::string& filePath) const {
+    // #include directives resolved with the defines of the label, the source its program is compiled from
+    return PreprocessShader(filePath, shaderDefines());
 }
 
 // Textures data management
 //-----------------------------------------------------------------------------------------
 // Convert image data to OpenGL texture (returns OpenGL valid Id)
 unsigned int graphics::LabelShader::loadTexture(const void* data, int width, int height, int format, int mipmapCount) {
-    glBindTexture(GL_TEXTURE_2D, 0);  // Free any old binding
+    GLState::instance().bindTexture(GL_TEXTURE_2D, 0);  // Free any old binding
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
     glGenTextures(1, &texture.id);  // Generate texture id
 
-    glBindTexture(GL_TEXTURE_2D, texture.id);
+    GLState::instance().bindTexture(GL_TEXTURE_2D, texture.id);
 
     int mipWidth = width;
     int mipHeight = height;
@@ -178,7 +158,10 @@ unsigned int graphics::LabelShader::loadTexture(const void* data, int width, int
         // TRACELOG("TEXTURE: Load mipmap level %i (%i x %i), size: %i, offset: %i", i, mipWidth, mipHeight, mipSize, mipOffset);
 
         if (glInternalFormat != 0) {
-            if (format < RL_PIXELFORMAT_COMPRESSED_DXT1_RGB) glTexImage2D(GL_TEXTURE_2D, i, glInternalFormat, mipWidth, mipHeight, 0, glFormat, glType, dataPtr);
+            if (format < RL_PIXELFORMAT_COMPRESSED_DXT1_RGB)
+                glTexImage2D(GL_TEXTURE_2D, i, glInternalFormat, mipWidth, mipHeight, 0, glFormat, glType, dataPtr);
+            else
+                glCompressedTexImage2D(GL_TEXTURE_2D, i, glInternalFormat, mipWidth, mipHeight, 0, mipSize, dataPtr);
 
             if (format == RL_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE) {
                 GLint swizzleMask[] = { GL_RED, GL_RED, GL_RED, GL_ONE };
@@ -216,7 +199,7 @@ unsigned int graphics::LabelShader::loadTexture(const void* data, int width, int
     // NOTE: If mipmaps were not in data, they are not generated automatically
 
     // Unbind current texture
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::instance().bindTexture(GL_TEXTURE_2D, 0);
 
     if (id > 0)
         TRACELOG(RL_LOG_INFO, "TEXTURE: [ID %i] Texture loaded successfully (%ix%i | %s | %i mipmaps)", id, width, height, rlGetPixelFormatName(format), mipmapCount);
@@ -247,95 +230,110 @@ void UnloadImage(Image image) {
     free(image.data);
 }
 
-void graphics::LabelShader::init_font(const std::string& fontPath) {
+void graphics::LabelShader::init_font(const std::string& fontPath, int fontType) {
     // Loading file to memory
     int fileSize = 0;
 
-    // unsigned char* fileData = LoadFileData(fontPath.c_str(), &fileSize);
-    unsigned char* fileData = LoadFileData("C:\\Users\\vitor\\Documents\\CODE\\C++\\ShaderTraining\\simple_test_project\\build\\assets\\fonts\\anonymous_pro_bold.ttf", &fileSize);
+    unsigned char* fileData = LoadFileData(fontPath.c_str(), &fileSize);
 
     // Default font generation from TTF font
     font.baseSize = 16;
     font.glyphCount = 95;
-    // Parameters > font size: 16, no glyphs array provided (0), glyphs count: 0 (defaults to 95)
-    font.glyphs = LoadFontData(fileData, fileSize, 16, 0, 0, FONT_SDF);
-    // Parameters > glyphs count: 95, font size: 16, glyphs padding in image: 0 px, pack method: 1 (Skyline algorythm)
-    Image atlas = GenImageFontAtlas(font.glyphs, &font.recs, 95, 16, 0, 1);
-    font.texture = LoadTextureFromImage(atlas);
-    UnloadImage(atlas);
-
-    free(fileData);  // Free memory from loaded file
-
-    SetTextureFilter(texture, TEXTURE_FILTER_BILINEAR);  // Required for SDF font
-}
+    font.glyphPadding = 0;
+
+    // SDF generation is expensive, reuse the atlas generated on a previous run when nothing changed
+    FontCacheKey cacheKey = MakeFontCacheKey(fileData, fileSize, font.baseSize, fontType, NULL, font.glyphCount, font.glyphPadding, 1);
+    std::string cachePath = GetFontCachePath(fontPath, cacheKey);
+
+    FontCacheFile cache;
+    if ((fileData != NULL) && cache.open(cachePath, cacheKey)) {
+        cache.loadGlyphs(&font.glyphs, &font.recs);
+        // Texture is uploaded straight from the mapped file
+        font.texture = LoadTextureFromImage(cache.atlasImage());
+        cache.close();
+    } else {
+        // Parameters > font size: 16, no glyphs array provided (0), glyphs count: 0 (defaults to 95)
+        font.glyphs = LoadFontData(fileData, fileSize, 16, 0, 0, fontType);
+        // Parameters > glyphs count: 95, font size: 16, glyphs padding in image: 0 px, pack method: 1 (Skyline algorythm)
+        Image atlas = GenImageFontAtlas(font.glyphs, &font.recs, 95, 16, 0, 1);
+        if (FONT_ATLAS_COMPRESSION && (atlas.format == PIXELFORMAT_UNCOMPRESSED_GRAYSCALE)) ImageCompressRGTC1(&atlas);
+        font.texture = LoadTextureFromImage(atlas);
+        SaveFontCache(cachePath, cacheKey, font.glyphs, font.recs, font.glyphCount, atlas);
+        UnloadImage(atlas);
+    }
 
-std::unordered_map<std::string, int> graphics::LabelShader::getAttributes() {
-    if (cachedAttributes.empty()) {
-        cachedAttributes = fetchAttributeLocations(program);
+    if ((font.texture.format == PIXELFORMAT_UNCOMPRESSED_GRAYSCALE) || (font.texture.format == PIXELFORMAT_COMPRESSED_RGTC1_R)) {
+        // Single channel atlas is sampled as alpha, same as GlyphAtlas
+        GLint swizzleMask[] = { GL_ONE, GL_ONE, GL_ONE, GL_RED };
+        GLState::instance().bindTexture(GL_TEXTURE_2D, font.texture.id);
+        glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask);
+        GLState::instance().bindTexture(GL_TEXTURE_2D, 0);
     }
 
-    return cachedAttributes;
-}
+    glyphIndices.build(font);
 
-std::unordered_map<std::string, UniformInfo> graphics::LabelShader::getUniforms() {
-    if (uniformMap.empty()) {
-        int numUniforms;
-        glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &numUniforms);
+    // Kerning between every pair of loaded glyphs
+    std::vector<int> codepoints(font.glyphCount);
+    for (int i = 0; i < font.glyphCount; i++) codepoints[i] = font.glyphs[i].value;
 
-        for (int i = 0; i < numUniforms; ++i) {
-            const GLsizei bufSize = 256;
-            GLsizei length;
-            GLint size;
-            GLenum type;
-            GLchar nameBuffer[bufSize];
+    int pairCount = 0;
+    KerningPair* pairs = LoadFontKerning(fileData, fileSize, font.baseSize, codepoints.data(), font.glyphCount, codepoints.data(), font.glyphCount, &pairCount);
+    layoutCache = std::make_shared<TextLayoutCache>();
+    layoutCache->kerning.add(pairs, pairCount);
+    free(pairs);
 
-            glGetActiveUniform(program, i, bufSize, &length, &size, &type, nameBuffer);
-
-            // Construct a std::string from the buffer with the correct length
-            std::string name(nameBuffer, length);
+    free(fileData);  // Free memory from loaded file
 
-            UniformInfo info;
-            info.type = type;
-            info.name = name;
-            info.size = size;
-            info.location = glGetUniformLocation(program, name.c_str());
+    SetTextureFilter(texture, TEXTURE_FILTER_BILINEAR);  // Required for SDF font
+}
 
-            uniformMap[name] = info;
-        }
+std::unordered_map<std::string, UniformInfo> graphics::LabelShader::getUniforms() {
+    // Declared uniforms come from the generated layouts, the program is not reflected
+    // NOTE: Label fragment shaders (sdf.frag and the ones including it, msdf.frag) declare the uniforms of sdf.frag
+    // The shadow values are shared by all labels using the program
+    std::unordered_map<std::string, UniformInfo>& sharedUniforms = ProgramRegistry::instance().uniforms(program);
+    if (sharedUniforms.empty()) {
+        if (renderMode == LABEL_RENDER_INSTANCED)
+            AddUniforms<shaders::text_instanced_vert>(program, sharedUniforms);
+        else
+            AddUniforms<shaders::text_vert>(program, sharedUniforms);
+        AddUniforms<shaders::sdf_frag>(program, sharedUniforms);
     }
+    uniformMap = sharedUniforms;
 
     return uniformMap;
 }
 
+bool graphics::LabelShader::programReady() {
+    if (uniformsResolved) return true;
+    if (!ProgramRegistry::instance().ready(program)) return false;
+
+    // cache uniforms
+    getUniforms();
+    // NOTE: text.vert and text_instanced.vert declare the same uniforms
+    positionScaleUniform = uniform<float>(shaders::text_vert::uniforms::positionScale);
+    modelUniform = uniform<Matrix4>(shaders::text_vert::uniforms::model);
+    textColorUniform = uniform<Color>(shaders::sdf_frag::uniforms::fragTextColor);
+    opacityUniform = uniform<float>(shaders::sdf_frag::uniforms::opacity);
+
+    uniformsResolved = true;
+    return true;
+}
+
 void graphics::LabelShader::set_glUniform1f(const std::string& uniformName, const float& newValue) {
-    auto it = uniformMap.find(uniformName);
-
-    if (it != uniformMap.end()) {
-        // Uniform found in the map
-        UniformInfo& info = it->second;
-        glUniform1f(info.location, newValue);
-        // Check for OpenGL errors
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            // Handle error (print error message, log, etc.)
-            std::cerr << "OpenGL error after setting glUniform1f variable: " << error << std::endl;
-        }
-    } else {
-        // Uniform not found in the map
-        std::cout << "Uniform '" << uniformName << "' not found in the map." << std::endl;
-    }
+    uniform<float>(uniformName).set(newValue);
 }
 
 void graphics::LabelShader::set_shader_text_color(const Color& newColor) {
-    auto it = uniformMap.find("fragTextColor");
-
-    if (it != uniformMap.end()) {
-        // Uniform found in the map
-        tint.r = newColor.r;
-        tint.g = newColor.g;
-        tint.b = newColor.b;
-        UniformInfo& info = it->second;
-        glUniform3f(info.location, newColor.r, newColor.g, newColor.b);
+    // Label wide color is a uniform in every render mode, instances are left untouched.
+    // Kept for render(), the program may still be compiling
+    tint.r = newColor.r;
+    tint.g = newColor.g;
+    tint.b = newColor.b;
+    if (!programReady()) return;
+
+    if (textColorUniform.valid()) {
+        textColorUniform.set(newColor);
     } else {
         // Uniform not found in the map
         std::cout << "Failed to set shader text color. Fragment shader doesn't use fragTextColor" << std::endl;
@@ -343,36 +341,11 @@ void graphics::LabelShader::set_shader_text_color(const Color& newColor) {
 }
 
 void graphics::LabelShader::set_glUniformMatrix3fv(const std::string& uniformName, const Matrix3& newValue) {
-    auto it = uniformMap.find(uniformName);
-
-    if (it != uniformMap.end()) {
-        // Uniform found in the map
-        UniformInfo& info = it->second;
-        glUniformMatrix3fv(info.location, 1, false, newValue.elements.data());
-    } else {
-        // Uniform not found in the map
-        std::cout << "Uniform '" << uniformName << "' not found in the map." << std::endl;
-    }
+    uniform<Matrix3>(uniformName).set(newValue);
 }
 
-void graphics::LabelShader::set_glUniformMatrix4fv(const std::string& uniformName, const Matrix4 newValue) {
-    glUseProgram(program);
-    auto it = uniformMap.find(uniformName);
-
-    if (it != uniformMap.end()) {
-        // Uniform found in the map
-        UniformInfo& info = it->second;
-        glUniformMatrix4fv(info.location, 1, false, newValue.elements.data());
-        // Check for OpenGL errors
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            // Handle error (print error message, log, etc.)
-            std::cerr << "OpenGL error after setting UniformMatrix4fv variable: " << error << std::endl;
-        }
-    } else {
-        // Uniform not found in the map
-        std::cout << "Uniform '" << uniformName << "' not found in the map." << std::endl;
-    }
+void graphics::LabelShader::set_glUniformMatrix4fv(const std::string& uniformName, const Matrix4& newValue) {
+    uniform<Matrix4>(uniformName).set(newValue);
 }
 
 //----------------------------------------------------------------------------------
@@ -439,7 +412,6 @@ void graphics::LabelShader::DrawTexturePro(Rectangle source, Rectangle dest, gra
         // rlVertex2f(topLeft.x, topLeft.y);
         vertexData.emplace_back(topLeft.x);
         vertexData.emplace_back(topLeft.y);
-        vertexData.emplace_back(this->position.z);
         if (flipX) {
             // rlTexCoord2f((source.x + source.width) / width, source.y / height);
             textCoordsData.emplace_back((source.x + source.width) / width);
@@ -454,7 +426,6 @@ void graphics::LabelShader::DrawTexturePro(Rectangle source, Rectangle dest, gra
         // rlVertex2f(bottomLeft.x, bottomLeft.y);
         vertexData.emplace_back(bottomLeft.x);
         vertexData.emplace_back(bottomLeft.y);
-        vertexData.emplace_back(this->position.z);
         if (flipX) {
             // rlTexCoord2f((source.x + source.width) / width, (source.y + source.height) / height);
             textCoordsData.emplace_back((source.x + source.width) / width);
@@ -469,7 +440,6 @@ void graphics::LabelShader::DrawTexturePro(Rectangle source, Rectangle dest, gra
         // rlVertex2f(bottomRight.x, bottomRight.y);
         vertexData.emplace_back(bottomRight.x);
         vertexData.emplace_back(bottomRight.y);
-        vertexData.emplace_back(this->position.z);
         if (flipX) {
             // rlTexCoord2f(source.x / width, (source.y + source.height) / height);
             textCoordsData.emplace_back(source.x / width);
@@ -484,7 +454,6 @@ void graphics::LabelShader::DrawTexturePro(Rectangle source, Rectangle dest, gra
         // rlVertex2f(topRight.x, topRight.y);
         vertexData.emplace_back(topRight.x);
         vertexData.emplace_back(topRight.y);
-        vertexData.emplace_back(this->position.z);
         if (flipX) {
             // rlTexCoord2f(source.x / width, source.y / height);
             textCoordsData.emplace_back(source.x / width);
@@ -503,7 +472,7 @@ void graphics::LabelShader::DrawTexturePro(Rectangle source, Rectangle dest, gra
 void graphics::LabelShader::DrawTextCodepoint(int codepoint, graphics::Vector2 position) {
     // Character index position in sprite font
     // NOTE: In case a codepoint is not available in the font, index returned points to '?'
-    int index = GetGlyphIndex(font, codepoint);
+    int index = getGlyphIndex(codepoint);
     float scaleFactor = fontSize / font.baseSize;  // Character quad scaling factor
     std::cout << "scaleFactor: " << scaleFactor << std::endl;
 
@@ -532,7 +501,7 @@ void graphics::LabelShader::DrawTextCodepoint(int codepoint, graphics::Vector2 p
 void graphics::LabelShader::DrawTextCodepoint3D(int codepoint, graphics::Vector3 position, bool backface) {
     // Character index position in sprite font
     // NOTE: In case a codepoint is not available in the font, index returned points to '?'
-    int index = GetGlyphIndex(font, codepoint);
+    int index = getGlyphIndex(codepoint);
     float scale = fontSize / (float)font.baseSize;
 
     // Character destination rectangle on screen
@@ -559,6 +528,13 @@ void graphics::LabelShader::DrawTextCodepoint3D(int codepoint, graphics::Vector3
         const float tw = (srcRec.x + srcRec.width) / font.texture.width;
         const float th = (srcRec.y + srcRec.height) / font.texture.height;
 
+        if (renderMode == LABEL_RENDER_INSTANCED) {
+            // One record per glyph, no backface needed as the quad always faces the camera
+            vertexData.insert(vertexData.end(), { position.x, position.y, width, height });
+            textCoordsData.insert(textCoordsData.end(), { tx, ty, tw, th });
+            return;
+        }
+
         // if (SHOW_LETTER_BOUNDRY) DrawCubeWiresV((Vector3){ position.x + width / 2, position.y, position.z + height / 2 }, (Vector3){ width, LETTER_BOUNDRY_SIZE, height }, LETTER_BOUNDRY_COLOR);
 
         // rlCheckRenderBatchLimit(4 + 4 * backface);
@@ -578,28 +554,24 @@ void graphics::LabelShader::DrawTextCodepoint3D(int codepoint, graphics::Vector3
         // rlVertex3f(x, y, z);  // Top Left Of The Texture and Quad
         vertexData.emplace_back(position.x);
         vertexData.emplace_back(position.y);
-        vertexData.emplace_back(position.z);
         // rlTexCoord2f(tx, th);
         textCoordsData.emplace_back(tx);
         textCoordsData.emplace_back(th);
         // rlVertex3f(x, y, z + height);  // Bottom Left Of The Texture and Quad
         vertexData.emplace_back(position.x);
         vertexData.emplace_back(position.y + height);
-        vertexData.emplace_back(position.z);
         // rlTexCoord2f(tw, th);
         textCoordsData.emplace_back(tw);
         textCoordsData.emplace_back(th);
         // rlVertex3f(x + width, y, z + height);  // Bottom Right Of The Texture and Quad
         vertexData.emplace_back(position.x + width);
         vertexData.emplace_back(position.y + height);
-        vertexData.emplace_back(position.z);
         // rlTexCoord2f(tw, ty);
         textCoordsData.emplace_back(tw);
         textCoordsData.emplace_back(ty);
         // rlVertex3f(x + width, y, z);  // Top Right Of The Texture and Quad
         vertexData.emplace_back(position.x + width);
         vertexData.emplace_back(position.y);
-        vertexData.emplace_back(position.z);
 
         if (backface) {
             // Back Face
@@ -610,28 +582,24 @@ void graphics::LabelShader::DrawTextCodepoint3D(int codepoint, graphics::Vector3
             // rlVertex3f(x, y, z);  // Top Right Of The Texture and Quad
             vertexData.emplace_back(position.x);
             vertexData.emplace_back(position.y);
-            vertexData.emplace_back(position.z);
             // rlTexCoord2f(tw, ty);
             textCoordsData.emplace_back(tw);
             textCoordsData.emplace_back(ty);
             // rlVertex3f(x + width, y, z);  // Top Left Of The Texture and Quad
             vertexData.emplace_back(position.x + width);
             vertexData.emplace_back(position.y);
-            vertexData.emplace_back(position.z);
             // rlTexCoord2f(tw, th);
             textCoordsData.emplace_back(tw);
             textCoordsData.emplace_back(th);
             // rlVertex3f(x + width, y, z + height);  // Bottom Left Of The Texture and Quad
             vertexData.emplace_back(position.x + width);
             vertexData.emplace_back(position.y + height);
-            vertexData.emplace_back(position.z);
             // rlTexCoord2f(tx, th);
             textCoordsData.emplace_back(tx);
             textCoordsData.emplace_back(th);
             // rlVertex3f(x, y, z + height);  // Bottom Right Of The Texture and Quad
             vertexData.emplace_back(position.x);
             vertexData.emplace_back(position.y + height);
-            vertexData.emplace_back(position.z);
         }
         // rlEnd();
         // rlPopMatrix();
@@ -642,58 +610,40 @@ void graphics::LabelShader::DrawTextCodepoint3D(int codepoint, graphics::Vector3
 
 // Draw a 2D text in 3D space
 void graphics::LabelShader::DrawText3D(graphics::Vector3 position, bool backface) {
-    int length = TextLength(labelText);  // Total length in bytes of the text, scanned by codepoints in loop
-
-    float textOffsetY = 0.0f;  // Offset between lines (on line break '\n')
-    float textOffsetX = 0.0f;  // Offset X to next character to draw
+    const TextLayout& layout = getLayout(labelText);
 
     float scale = fontSize / (float)font.baseSize;
+    // NOTE: Fixed line spacing of 1.5 line-height
+    float lineAdvance = scale + lineSpace / (float)font.baseSize * scale;
 
-    for (int i = 0; i < length;) {
-        // Get next codepoint from byte string and glyph index in font
-        int codepointByteCount = 0;
-        int codepoint = GetCodepointNext(&labelText[i], &codepointByteCount);
-        int index = GetGlyphIndex(font, codepoint);
-
-        // NOTE: Normally we exit the decoding sequence as soon as a bad byte is found (and return 0x3f)
-        // but we need to draw all of the bad bytes using the '?' symbol moving one byte
-        if (codepoint == 0x3f) codepointByteCount = 1;
+    for (const LayoutGlyph& glyph : layout.glyphs) {
+        // Every codepoint before the glyph on its line adds spacing
+        float textOffsetX = (glyph.penX + (float)glyph.column * spacing) / (float)font.baseSize * scale;
+        float textOffsetY = (float)glyph.line * lineAdvance;
 
-        if (codepoint == '\n') {
-            // NOTE: Fixed line spacing of 1.5 line-height
-            // TODO: Support custom line spacing defined by user
-            textOffsetY += scale + lineSpace / (float)font.baseSize * scale;
-            textOffsetX = 0.0f;
-        } else {
-            if ((codepoint != ' ') && (codepoint != '\t')) {
-                DrawTextCodepoint3D(codepoint, { position.x + textOffsetX, position.y + textOffsetY, position.z }, backface);
-            }
+        DrawTextCodepoint3D(glyph.codepoint, { position.x + textOffsetX, position.y + textOffsetY, position.z }, backface);
+    }
+}
 
-            if (font.glyphs[index].advanceX == 0)
-                textOffsetX += (float)(font.recs[index].width + spacing) / (float)font.baseSize * scale;
-            else
-                textOffsetX += (float)(font.glyphs[index].advanceX + spacing) / (float)font.baseSize * scale;
-        }
+const TextLayout& graphics::LabelShader::getLayout(const char* text) {
+    if (layoutCache == nullptr) layoutCache = std::make_shared<TextLayoutCache>();
 
-        i += codepointByteCount;  // Move text bytes counter to next codepoint
-    }
+    return layoutCache->get(text, font, [this](int codepoint) { return getGlyphIndex(codepoint); });
 }
 
 // Draw text using Font
 // NOTE: chars spacing is NOT proportional to fontSize
 void graphics::LabelShader::DrawTextEx(graphics::Vector3 position) {
-    int size = TextLength(labelText);  // Total size in bytes of the text, scanned by codepoints in loop
+    std::vector<int> codepoints;
+    DecodeUtf8(labelText, TextLength(labelText), codepoints);
 
     int textOffsetY = 0;       // Offset between lines (on linebreak '\n')
     float textOffsetX = 0.0f;  // Offset X to next character to draw
 
     float scaleFactor = fontSize / font.baseSize;  // Character quad scaling factor
 
-    for (int i = 0; i < size;) {
-        // Get next codepoint from byte string and glyph index in font
-        int codepointByteCount = 0;
-        int codepoint = GetCodepointNext(&labelText[i], &codepointByteCount);
-        int index = GetGlyphIndex(font, codepoint);
+    for (int codepoint : codepoints) {
+        int index = getGlyphIndex(codepoint);
 
         if (codepoint == '\n') {
             // NOTE: Line spacing is a global variable, use SetTextLineSpacing() to setup
@@ -711,8 +661,6 @@ void graphics::LabelShader::DrawTextEx(graphics::Vector3 position) {
             else
                 textOffsetX += ((float)font.glyphs[index].advanceX * scaleFactor + spacing);
         }
-
-        i += codepointByteCount;  // Move text bytes counter to next codepoint
     }
 }
 
@@ -725,61 +673,215 @@ void graphics::LabelShader::DrawTexture(int posX, int posY, float rotation, floa
     DrawTexturePro(source, dest, origin, rotation);
 }
 
-void graphics::LabelShader::buildIndexBufferData() {
-    // from Raylib
-    unsigned int k = 0;
+int graphics::LabelShader::getGlyphIndex(int codepoint) {
+    if (glyphAtlas == nullptr) return glyphIndices.get(codepoint);
 
-    // Indices can be initialized right now
-    for (int j = 0; j < vertexData.size(); j += 6) {
-        indexData.emplace_back(4 * k);
-        indexData.emplace_back(4 * k + 1);
-        indexData.emplace_back(4 * k + 2);
-        indexData.emplace_back(4 * k);
-        indexData.emplace_back(4 * k + 2);
-        indexData.emplace_back(4 * k + 3);
-        k++;
-    }
+    int index = glyphAtlas->getGlyphIndex(codepoint);
+    atlasSlots.emplace_back(index);
+
+    return index;
 }
 
 void graphics::LabelShader::buildVertices(graphics::Vector3 fontPosition) {
+    vertexData.clear();
+    textCoordsData.clear();
+    atlasSlots.clear();
+
     // DrawTextEx(fontPosition);
     DrawText3D(fontPosition, true);
     //  DrawTexture(10, 10, 0, 1.0f);
-    buildIndexBufferData();
+    if (renderMode == LABEL_RENDER_INSTANCED)
+        packInstances();
+    else
+        packVertices();
 }
 
-// vertexSize is size of point(Vector2, Vector3, etc...) = 2, 3, etc...
-void graphics::LabelShader::createTextBuffer(GLenum usage) {
-    std::string position = "position";
-    std::string vertexTexCoord = "vertexTexCoord";
-    int positionLocation = cachedAttributes[position];
-    int vertexTexCoordLocation = cachedAttributes[vertexTexCoord];
+// Power of two above the largest layout coordinate, so small text edits don't change every vertex
+static float GetPositionScale(const std::vector<float>& layout) {
+    float extent = 0.0f;
+    for (float coordinate : layout) extent = std::max(extent, std::fabs(coordinate));
+
+    return (extent > 0.0f) ? std::exp2(std::ceil(std::log2(extent))) : 1.0f;
+}
+
+static int16_t PackSnorm16(float value, float scale) {
+    return (int16_t)std::lround(std::clamp(value / scale, -1.0f, 1.0f) * 32767.0f);
+}
+
+static uint16_t PackUnorm16(float value) {
+    return (uint16_t)std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f);
+}
+
+// Quantizes the layout into the interleaved vertex buffer format
+// NOTE: Positions are divided by positionScale so they fit snorm16, text.vert scales them back
+void graphics::LabelShader::packVertices() {
+    positionScale = GetPositionScale(vertexData);
+
+    size_t vertexCount = vertexData.size() / 2;
+    vertices.resize(vertexCount);
+
+    for (size_t i = 0; i < vertexCount; i++) {
+        vertices[i].x = PackSnorm16(vertexData[i * 2], positionScale);
+        vertices[i].y = PackSnorm16(vertexData[i * 2 + 1], positionScale);
+        vertices[i].u = PackUnorm16(textCoordsData[i * 2]);
+        vertices[i].v = PackUnorm16(textCoordsData[i * 2 + 1]);
+    }
+}
+
+// Quantizes the layout into one record per glyph, vertexData holds x, y, width, height
+// and textCoordsData the atlas rectangle of every glyph
+void graphics::LabelShader::packInstances() {
+    positionScale = GetPositionScale(vertexData);
+
+    // Tint and opacity are uniforms, glyphs have no color of their own
+    const unsigned char color[4] = { 255, 255, 255, 255 };
+
+    size_t glyphCount = vertexData.size() / 4;
+    instances.resize(glyphCount);
+
+    for (size_t i = 0; i < glyphCount; i++) {
+        GlyphInstance& instance = instances[i];
+        instance.x = PackSnorm16(vertexData[i * 4], positionScale);
+        instance.y = PackSnorm16(vertexData[i * 4 + 1], positionScale);
+        instance.width = PackSnorm16(vertexData[i * 4 + 2], positionScale);
+        instance.height = PackSnorm16(vertexData[i * 4 + 3], positionScale);
+        instance.u0 = PackUnorm16(textCoordsData[i * 4]);
+        instance.v0 = PackUnorm16(textCoordsData[i * 4 + 1]);
+        instance.u1 = PackUnorm16(textCoordsData[i * 4 + 2]);
+        instance.v1 = PackUnorm16(textCoordsData[i * 4 + 3]);
+        memcpy(&instance.r, color, sizeof(color));
+    }
+}
+
+void graphics::LabelShader::rebuildVertices() {
+    std::vector<TextVertex> previousVertices;
+    std::vector<GlyphInstance> previousInstances;
+    previousVertices.swap(vertices);
+    previousInstances.swap(instances);
+
+    // Adding glyphs to the atlas can move the ones already laid out, repeat until nothing moved
+    do {
+        if (glyphAtlas != nullptr) atlasGeneration = glyphAtlas->generation;
+        buildVertices({ 0.0f, 0.0f, 0.0f });
+    } while ((glyphAtlas != nullptr) && (atlasGeneration != glyphAtlas->generation));
+
+    positionScaleUniform.set(positionScale);  // Not uploaded when the scale did not change
+
+    if (renderMode == LABEL_RENDER_INSTANCED)
+        uploadRecords(instances.data(), instances.size(), previousInstances.data(), previousInstances.size(), sizeof(GlyphInstance));
+    else
+        uploadRecords(vertices.data(), vertices.size() / 4, previousVertices.data(), previousVertices.size() / 4, 4 * sizeof(TextVertex));
+}
+
+void graphics::LabelShader::setText(const std::string& text) {
+    if ((labelText == ownedText.c_str()) && (ownedText == text)) return;
+
+    ownedText = text;
+    labelText = ownedText.c_str();
+    rebuildVertices();
+}
+
+void graphics::LabelShader::setStyle(float newFontSize, float newSpacing, float newLineSpace) {
+    if ((fontSize == newFontSize) && (spacing == newSpacing) && (lineSpace == newLineSpace)) return;
+
+    fontSize = newFontSize;
+    spacing = newSpacing;
+    lineSpace = newLineSpace;
+    rebuildVertices();
+}
+
+// Uploads count records (a 4 vertices quad or a glyph instance), only the ones that differ
+// from previous are written with glBufferSubData
+// NOTE: Buffers grow geometrically, extra records past the end are not drawn so they are never cleared
+void graphics::LabelShader::uploadRecords(const void* data, size_t count, const void* previous, size_t previousCount, size_t recordSize) {
+    const unsigned char* records = (const unsigned char*)data;
+    const unsigned char* previousRecords = (const unsigned char*)previous;
+
+    GLState::instance().bindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+    if (count > quadCapacity) {
+        quadCapacity = std::max(count, quadCapacity * 2);
+
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(quadCapacity * recordSize), NULL, bufferUsage);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(count * recordSize), records);
 
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &pointsVBO);
-    glGenBuffers(1, &textCoordsVBO);
+        // Instances only index the first quad
+        QuadIndexBuffer::instance().bind((renderMode == LABEL_RENDER_INSTANCED) ? 1 : quadCapacity);
+    } else {
+        auto recordChanged = [&](size_t r) {
+            return (r >= previousCount) || (memcmp(records + r * recordSize, previousRecords + r * recordSize, recordSize) != 0);
+        };
+
+        // Changed records separated by a few unchanged ones are merged into a single upload
+        size_t r = 0;
+        while (r < count) {
+            if (!recordChanged(r)) {
+                r++;
+                continue;
+            }
 
-    // Upload vertex data
-    glBindVertexArray(VAO);
+            size_t start = r;
+            size_t end = r + 1;
+            for (r = end; (r < count) && (r - end < LABEL_UPLOAD_MERGE_GAP); r++) {
+                if (recordChanged(r)) end = r + 1;
+            }
 
-    glBindBuffer(GL_ARRAY_BUFFER, pointsVBO);
-    glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), usage);
+            glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(start * recordSize), (GLsizeiptr)((end - start) * recordSize), records + start * recordSize);
+            r = end;
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Creates the GL objects once, later calls only upload the vertices
+void graphics::LabelShader::createTextBuffer(GLenum usage) {
+    bufferUsage = usage;
+
+    if (VAO == 0) {
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+
+        GLState::instance().bindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+        if (renderMode == LABEL_RENDER_INSTANCED) {
+            // One record per glyph, text_instanced.vert expands it to the quad corner given by gl_VertexID
+            auto instanceAttribute = [](const ShaderAttribute& attribute, GLint size, GLenum type, size_t offset) {
+                glEnableVertexAttribArray(attribute.location);
+                glVertexAttribPointer(attribute.location, size, type, GL_TRUE, sizeof(GlyphInstance), (const void*)offset);
+                glVertexAttribDivisor(attribute.location, 1);
+            };
+
+            using attributes = shaders::text_instanced_vert::attributes;
+            instanceAttribute(attributes::glyphRect, 4, GL_SHORT, offsetof(GlyphInstance, x));
+            instanceAttribute(attributes::glyphTexRect, 4, GL_UNSIGNED_SHORT, offsetof(GlyphInstance, u0));
+            instanceAttribute(attributes::glyphColor, 4, GL_UNSIGNED_BYTE, offsetof(GlyphInstance, r));
+        } else {
+            GLuint positionLocation = shaders::text_vert::attributes::position.location;
+            GLuint vertexTexCoordLocation = shaders::text_vert::attributes::vertexTexCoord.location;
 
-    glEnableVertexAttribArray(positionLocation);
-    glVertexAttribPointer(positionLocation, 3, GL_FLOAT, 0, 0, 0);
+            // Interleaved: snorm16 position, unorm16 texture coordinates
+            glEnableVertexAttribArray(positionLocation);
+            glVertexAttribPointer(positionLocation, 2, GL_SHORT, GL_TRUE, sizeof(TextVertex), (const void*)offsetof(TextVertex, x));
 
-    glBindBuffer(GL_ARRAY_BUFFER, textCoordsVBO);
-    glBufferData(GL_ARRAY_BUFFER, textCoordsData.size() * sizeof(float), textCoordsData.data(), usage);
+            glEnableVertexAttribArray(vertexTexCoordLocation);
+            glVertexAttribPointer(vertexTexCoordLocation, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(TextVertex), (const void*)offsetof(TextVertex, u));
+        }
 
-    glEnableVertexAttribArray(vertexTexCoordLocation);
-    glVertexAttribPointer(vertexTexCoordLocation, 2, GL_FLOAT, 0, 0, 0);
+        // NOTE: Element buffer binding is stored in the VAO
+        QuadIndexBuffer::instance().bind(1);
 
-    // build index buffer
-    glGenBuffers(1, &indexVBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexVBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizei)(indexData.size() * sizeof(unsigned int)), indexData.data(), GL_STATIC_DRAW);
+        GLState::instance().bindVertexArray(0);
+    }
 
-    glBindVertexArray(0);
+    // Upload everything again to buffers sized for the current text
+    quadCapacity = 0;
+    if (renderMode == LABEL_RENDER_INSTANCED)
+        uploadRecords(instances.data(), instances.size(), NULL, 0, sizeof(GlyphInstance));
+    else
+        uploadRecords(vertices.data(), vertices.size() / 4, NULL, 0, 4 * sizeof(TextVertex));
 }
 
 //----------------------------------------------------------------------------------
@@ -788,38 +890,54 @@ void graphics::LabelShader::createTextBuffer(GLenum usage) {
 
 // Use the shader program
 void graphics::LabelShader::Use() const {
-    glUseProgram(program);
+    GLState::instance().useProgram(program);
 }
 
 void graphics::LabelShader::render() {
-    glUseProgram(program);
-
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glFrontFace(GL_CCW);
-    glEnable(GL_BLEND);
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_SCISSOR_TEST);
-    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-    glStencilMask(0xffffffff);
-    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
-    glStencilFunc(GL_ALWAYS, 0, 0xffffffff);
-
-    glBindVertexArray(VAO);
+    if (glyphAtlas != nullptr) {
+        if (atlasGeneration != glyphAtlas->generation) rebuildVertices();
+        glyphAtlas->touch(atlasSlots);
+        glyphAtlas->flush();
+    }
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texture.id);
+    // Never waits for the compiler, the label shows up once its program is linked
+    if (!programReady()) return;
+
+    // Redundant state changes are skipped by GLState, nothing is unbound after drawing
+    GLState& state = GLState::instance();
+    state.useProgram(program);
+    // Camera matrices come from CameraUniformBuffer, the program may be shared so every label
+    // sets its own uniforms, values already uploaded by the previous label are skipped
+    modelUniform.set(*matrixWorld);
+    positionScaleUniform.set(positionScale);
+    if (textColorUniform.valid()) textColorUniform.set(tint);
+    if (opacityUniform.valid()) opacityUniform.set(opacity);
+
+    state.enable(GL_CULL_FACE);
+    state.cullFace(GL_BACK);
+    state.frontFace(GL_CCW);
+    state.enable(GL_BLEND);
+    state.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state.disable(GL_DEPTH_TEST);
+    state.disable(GL_SCISSOR_TEST);
+    state.colorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    state.stencilMask(0xffffffff);
+    state.stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    state.stencilFunc(GL_ALWAYS, 0, 0xffffffff);
+
+    state.bindVertexArray(VAO);
+
+    state.activeTexture(GL_TEXTURE0);
+    state.bindTexture(GL_TEXTURE_2D, texture.id);
 
-    // glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexVBO);
     //  glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(vertexData.size() / 3));
 
-    // glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indexData.size()), GL_UNSIGNED_INT, (GLvoid*)(0 * sizeof(unsigned int)));
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indexData.size()), GL_UNSIGNED_INT, 0);
-    print_opengl_error();
-
-    glBindVertexArray(0);
-    glUseProgram(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    // Shared quad index buffer, bound in the VAO
+    GL_DEBUG_MARK();
+    if (renderMode == LABEL_RENDER_INSTANCED)
+        glDrawElementsInstanced(GL_TRIANGLES, 6, QuadIndexBuffer::instance().indexType(), 0, static_cast<GLsizei>(instances.size()));
+    else
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(vertices.size() / 4 * 6), QuadIndexBuffer::instance().indexType(), 0);
 }
 
 void graphics::LabelShader::renderIndexAttribute(int start, int count) {
@@ -828,6 +946,6 @@ void graphics::LabelShader::renderIndexAttribute(int start, int count) {
 }
 
 void graphics::LabelShader::destroy() {
-    glDeleteProgram(program);
+    ProgramRegistry::instance().release(program);
     this->program = -1;
 }
@@ -0,0 +1,320 @@
+#include "Label/TextBatch.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+
+#include "GLDebug.hpp"
+#include "GLState.hpp"
+#include "ProgramRegistry.hpp"
+#include "ShaderLayouts.hpp"
+
+namespace {
+
+unsigned char ColorToByte(float value) {
+    return (unsigned char)(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+}  // namespace
+
+graphics::TextBatch::TextBatch(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const Font& font) : font(font) {
+    createProgram(vertexShaderPath, fragmentShaderPath);
+    createBuffers();
+}
+
+graphics::TextBatch::TextBatch(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, std::shared_ptr<GlyphAtlas> atlas) : glyphAtlas(atlas) {
+    font = glyphAtlas->font;  // NOTE: atlas glyph arrays are never reallocated, sharing the pointers is safe
+    createProgram(vertexShaderPath, fragmentShaderPath);
+    createBuffers();
+}
+
+graphics::TextBatch::TextBatch(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, std::shared_ptr<TextureArrayAtlas> atlas) : arrayAtlas(atlas) {
+    createProgram(vertexShaderPath, fragmentShaderPath);
+    createBuffers();
+}
+
+graphics::TextBatch::~TextBatch() {
+    glDeleteBuffers(1, &VBO);
+    GLState::instance().deleteVertexArray(VAO);
+    ProgramRegistry::instance().release(program);
+}
+
+void graphics::TextBatch::createProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath) {
+    // NOTE: Camera matrices come from the Camera block and texture0 samples unit 0, no uniform is set
+    // Batched text always faces the camera
+    program = ProgramRegistry::instance().acquire(vertexShaderPath, fragmentShaderPath, { { "BILLBOARD", "" } }, BindAttributeLocations<shaders::text_batch_vert>);
+}
+
+void graphics::TextBatch::createBuffers() {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    GLState::instance().bindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+    auto enableAttribute = [](const ShaderAttribute& attribute, GLint size, GLenum type, GLboolean normalized, size_t offset) {
+        glEnableVertexAttribArray(attribute.location);
+        glVertexAttribPointer(attribute.location, size, type, normalized, sizeof(TextBatchVertex), (const void*)offset);
+    };
+
+    using attributes = shaders::text_batch_vert::attributes;
+    enableAttribute(attributes::position, 2, GL_FLOAT, GL_FALSE, offsetof(TextBatchVertex, x));
+    enableAttribute(attributes::vertexTexCoord, 2, GL_FLOAT, GL_FALSE, offsetof(TextBatchVertex, u));
+    enableAttribute(attributes::vertexLayer, 1, GL_FLOAT, GL_FALSE, offsetof(TextBatchVertex, layer));
+    enableAttribute(attributes::labelOrigin, 3, GL_FLOAT, GL_FALSE, offsetof(TextBatchVertex, originX));
+    enableAttribute(attributes::vertexColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(TextBatchVertex, r));
+
+    GLState::instance().bindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void graphics::TextBatch::begin() {
+    // Keep the pages and their allocations, only the quads are discarded
+    for (Page& page : pages) {
+        page.vertices.clear();
+        page.glyphs.clear();
+    }
+
+    if (glyphAtlas != nullptr) atlasGeneration = glyphAtlas->generation;
+}
+
+void graphics::TextBatch::add(const char* text, const Vector3& position, const Color& color, float opacity, float fontSize, float spacing) {
+    // NOTE: Array batches have no default font, the quads would sample texture 0
+    if (arrayAtlas != nullptr) {
+        std::cerr << "TextBatch: text added without a font id to a texture array batch" << std::endl;
+        throw std::runtime_error("Texture array batch requires a font id");
+    }
+
+    addText(getPage(font, nullptr), text, position, color, opacity, fontSize, spacing, lineSpace);
+}
+
+void graphics::TextBatch::add(const char* text, int fontId, const Vector3& position, const Color& color, float opacity, float fontSize, float spacing) {
+    if (arrayAtlas == nullptr) {
+        std::cerr << "TextBatch: font id " << fontId << " given to a batch without a texture array atlas" << std::endl;
+        throw std::runtime_error("Font ids require a texture array batch");
+    }
+
+    const TextureArrayAtlas::AtlasFont& atlasFont = arrayAtlas->getFont(fontId);
+
+    Page& page = getPage(atlasFont.font, atlasFont.layoutCache);
+    page.textureTarget = GL_TEXTURE_2D_ARRAY;
+    page.glyphLayers = atlasFont.glyphLayers.data();
+
+    addText(page, text, position, color, opacity, fontSize, spacing, lineSpace);
+}
+
+void graphics::TextBatch::add(const LabelShader& label) {
+    // Labels sample a 2D atlas, the program of an array batch samples a sampler2DArray
+    if (arrayAtlas != nullptr) {
+        std::cerr << "TextBatch: label [" << label.labelText << "] added to a texture array batch" << std::endl;
+        throw std::runtime_error("Texture array batch can't draw 2D atlas labels");
+    }
+
+    const auto& elements = label.matrixWorld->elements;
+    Vector3 origin(elements[12], elements[13], elements[14]);
+
+    addText(getPage(label.font, label.layoutCache), label.labelText, origin, label.tint, label.opacity, label.fontSize, label.spacing, label.lineSpace);
+}
+
+graphics::TextBatch::Page& graphics::TextBatch::getPage(const Font& pageFont, std::shared_ptr<TextLayoutCache> layoutCache) {
+    for (Page& page : pages) {
+        if ((page.font.texture.id == pageFont.texture.id) && (page.font.glyphs == pageFont.glyphs)) return page;
+    }
+
+    Page page;
+    page.font = pageFont;
+    page.layoutCache = layoutCache;
+
+    if ((glyphAtlas != nullptr) && (pageFont.texture.id == glyphAtlas->font.texture.id)) {
+        page.layoutCache = glyphAtlas->layoutCache;
+    } else {
+        page.glyphIndices.build(pageFont);
+    }
+
+    // NOTE: Fonts given without a label have no kerning
+    if (page.layoutCache == nullptr) page.layoutCache = std::make_shared<TextLayoutCache>();
+    pages.emplace_back(std::move(page));
+
+    return pages.back();
+}
+
+int graphics::TextBatch::getGlyphIndex(const Page& page, int codepoint) {
+    if ((glyphAtlas != nullptr) && (page.font.texture.id == glyphAtlas->font.texture.id)) return glyphAtlas->getGlyphIndex(codepoint);
+
+    return page.glyphIndices.get(codepoint);
+}
+
+// Same layout as LabelShader::DrawText3D()
+void graphics::TextBatch::addText(Page& page, const char* text, const Vector3& position, const Color& color, float opacity, float fontSize, float spacing, float lineSpacing) {
+    if ((text == NULL) || (page.font.glyphs == NULL)) return;
+
+    const Font& pageFont = page.font;
+    const unsigned char vertexColor[4] = { ColorToByte(color.r), ColorToByte(color.g), ColorToByte(color.b), ColorToByte(opacity) };
+
+    const TextLayout& layout = page.layoutCache->get(text, pageFont, [this, &page](int codepoint) { return getGlyphIndex(page, codepoint); });
+
+    float scale = fontSize / (float)pageFont.baseSize;
+    float lineAdvance = scale + lineSpacing / (float)pageFont.baseSize * scale;
+
+    for (const LayoutGlyph& glyph : layout.glyphs) {
+        float textOffsetX = (glyph.penX + (float)glyph.column * spacing) / (float)pageFont.baseSize * scale;
+        float textOffsetY = (float)glyph.line * lineAdvance;
+
+        addGlyphQuad(page, getGlyphIndex(page, glyph.codepoint), textOffsetX, textOffsetY, scale, position, vertexColor);
+    }
+}
+
+void graphics::TextBatch::addGlyphQuad(Page& page, int index, float x, float y, float scale, const Vector3& origin, const unsigned char color[4]) {
+    const Font& pageFont = page.font;
+
+    x += (float)(pageFont.glyphs[index].offsetX - pageFont.glyphPadding) / (float)pageFont.baseSize * scale;
+    y += (float)(pageFont.glyphs[index].offsetY - pageFont.glyphPadding) / (float)pageFont.baseSize * scale;
+
+    float width = (float)(pageFont.recs[index].width + 2.0f * pageFont.glyphPadding) / (float)pageFont.baseSize * scale;
+    float height = (float)(pageFont.recs[index].height + 2.0f * pageFont.glyphPadding) / (float)pageFont.baseSize * scale;
+
+    // Top left, bottom left, bottom right, top right
+    const float corners[4][2] = { { x, y }, { x, y + height }, { x + width, y + height }, { x + width, y } };
+
+    size_t first = page.vertices.size();
+    for (const auto& corner : corners) {
+        TextBatchVertex vertex;
+        vertex.x = corner[0];
+        vertex.y = corner[1];
+        vertex.originX = origin.x;
+        vertex.originY = origin.y;
+        vertex.originZ = origin.z;
+        vertex.r = color[0];
+        vertex.g = color[1];
+        vertex.b = color[2];
+        vertex.a = color[3];
+        page.vertices.emplace_back(vertex);
+    }
+
+    setGlyphTexCoords(page, &page.vertices[first], index);
+    page.glyphs.emplace_back(index);
+}
+
+void graphics::TextBatch::setGlyphTexCoords(const Page& page, TextBatchVertex* quad, int index) {
+    const Font& pageFont = page.font;
+
+    // Character source rectangle from font texture atlas
+    Rectangle srcRec = { pageFont.recs[index].x - (float)pageFont.glyphPadding, pageFont.recs[index].y - (float)pageFont.glyphPadding,
+                         pageFont.recs[index].width + 2.0f * pageFont.glyphPadding, pageFont.recs[index].height + 2.0f * pageFont.glyphPadding };
+
+    // normalized texture coordinates of the glyph inside the font texture (0.0f -> 1.0f)
+    const float tx = srcRec.x / pageFont.texture.width;
+    const float ty = srcRec.y / pageFont.texture.height;
+    const float tw = (srcRec.x + srcRec.width) / pageFont.texture.width;
+    const float th = (srcRec.y + srcRec.height) / pageFont.texture.height;
+
+    const float layer = (page.glyphLayers != nullptr) ? (float)page.glyphLayers[index] : 0.0f;
+    for (int i = 0; i < 4; i++) quad[i].layer = layer;
+
+    quad[0].u = tx;
+    quad[0].v = ty;
+    quad[1].u = tx;
+    quad[1].v = th;
+    quad[2].u = tw;
+    quad[2].v = th;
+    quad[3].u = tw;
+    quad[3].v = ty;
+}
+
+void graphics::TextBatch::draw() {
+    drawCalls = 0;
+
+    if (glyphAtlas != nullptr) {
+        // Glyphs added later in the frame can move the ones already laid out, only texture coordinates change
+        if (atlasGeneration != glyphAtlas->generation) {
+            for (Page& page : pages) {
+                if (page.font.texture.id != glyphAtlas->font.texture.id) continue;
+
+                for (size_t q = 0; q < page.glyphs.size(); q++) setGlyphTexCoords(page, &page.vertices[q * 4], page.glyphs[q]);
+            }
+
+            atlasGeneration = glyphAtlas->generation;
+        }
+
+        glyphAtlas->flush();
+    }
+
+    if (arrayAtlas != nullptr) arrayAtlas->flush();
+
+    // Pages sampling the same texture are stored next to each other and drawn with one call
+    std::vector<const Page*> order;
+    size_t totalVertices = 0;
+    for (const Page& page : pages) {
+        if (page.vertices.empty()) continue;
+
+        order.emplace_back(&page);
+        totalVertices += page.vertices.size();
+    }
+    if (totalVertices == 0) return;
+    // Nothing is drawn until the program is linked, the batch never waits for the compiler
+    if (!ProgramRegistry::instance().ready(program)) return;
+
+    std::stable_sort(order.begin(), order.end(), [](const Page* a, const Page* b) {
+        if (a->textureTarget != b->textureTarget) return a->textureTarget < b->textureTarget;
+        return a->font.texture.id < b->font.texture.id;
+    });
+
+    // Stream all pages into one buffer, orphaning the previous storage avoids waiting on the GPU
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    if (totalVertices > vertexCapacity) vertexCapacity = std::max(totalVertices, vertexCapacity * 2);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(vertexCapacity * sizeof(TextBatchVertex)), NULL, GL_STREAM_DRAW);
+
+    size_t offset = 0;
+    for (const Page* page : order) {
+        glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(offset * sizeof(TextBatchVertex)), (GLsizeiptr)(page->vertices.size() * sizeof(TextBatchVertex)), page->vertices.data());
+        offset += page->vertices.size();
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    GLState& state = GLState::instance();
+    state.useProgram(program);
+
+    state.enable(GL_CULL_FACE);
+    state.cullFace(GL_BACK);
+    state.frontFace(GL_CCW);
+    state.enable(GL_BLEND);
+    state.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state.disable(GL_DEPTH_TEST);
+
+    // NOTE: Element buffer binding is stored in the VAO
+    state.bindVertexArray(VAO);
+    QuadIndexBuffer& quadIndices = QuadIndexBuffer::instance();
+    quadIndices.bind(totalVertices / 4);
+
+    state.activeTexture(GL_TEXTURE0);
+
+    // Quad indices are 4*k based, the index offset of a run of pages selects its first vertex
+    size_t firstQuad = 0;
+    for (size_t i = 0; i < order.size();) {
+        const Page* first = order[i];
+        size_t quads = 0;
+
+        for (; (i < order.size()) && (order[i]->textureTarget == first->textureTarget) && (order[i]->font.texture.id == first->font.texture.id); i++) {
+            quads += order[i]->vertices.size() / 4;
+        }
+
+        state.bindTexture(first->textureTarget, first->font.texture.id);
+        GL_DEBUG_MARK();
+        glDrawElements(GL_TRIANGLES, (GLsizei)(quads * 6), quadIndices.indexType(), quadIndices.quadOffset(firstQuad));
+        drawCalls++;
+
+        firstQuad += quads;
+    }
+}
+
+int graphics::TextBatch::quadCount() const {
+    size_t quads = 0;
+    for (const Page& page : pages) quads += page.glyphs.size();
+
+    return (int)quads;
+}
+
+int graphics::TextBatch::drawCallCount() const {
+    return drawCalls;
+}
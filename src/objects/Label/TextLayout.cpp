@@ -0,0 +1,100 @@
+#include "Label/TextLayout.hpp"
+
+//
+#include "Label/Utf8.hpp"
+
+namespace {
+
+uint64_t PairKey(int first, int second) {
+    return ((uint64_t)(uint32_t)first << 32) | (uint32_t)second;
+}
+
+}  // namespace
+
+void KerningTable::add(const KerningPair* newPairs, int count) {
+    for (int i = 0; i < count; i++) pairs[PairKey(newPairs[i].first, newPairs[i].second)] = newPairs[i].advance;
+}
+
+void KerningTable::clear() {
+    pairs.clear();
+}
+
+float KerningTable::get(int first, int second) const {
+    if (pairs.empty()) return 0.0f;
+
+    auto it = pairs.find(PairKey(first, second));
+
+    return (it != pairs.end()) ? it->second : 0.0f;
+}
+
+TextLayoutCache::TextLayoutCache(size_t capacity) : capacity((capacity > 0) ? capacity : 1) {}
+
+const TextLayout& TextLayoutCache::get(const char* text, const Font& font, const std::function<int(int)>& getGlyphIndex) {
+    std::string key = (text != NULL) ? text : "";
+
+    auto it = lookup.find(key);
+    if (it != lookup.end()) {
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->second;
+    }
+
+    if (entries.size() >= capacity) {
+        lookup.erase(entries.back().first);
+        entries.pop_back();
+    }
+
+    entries.emplace_front(key, build(key, font, getGlyphIndex));
+    lookup.emplace(std::move(key), entries.begin());
+
+    return entries.front().second;
+}
+
+void TextLayoutCache::invalidate() {
+    entries.clear();
+    lookup.clear();
+}
+
+// Same rules as LabelShader::DrawText3D(): advanceX (or the glyph width when it is 0) plus kerning
+TextLayout TextLayoutCache::build(const std::string& text, const Font& font, const std::function<int(int)>& getGlyphIndex) {
+    TextLayout layout;
+
+    // NOTE: Bad bytes are decoded one by one as '?' so they are all drawn with the '?' symbol
+    codepoints.clear();
+    size_t invalidBytes = DecodeUtf8(text.data(), text.size(), codepoints);
+    if (invalidBytes > 0) TRACELOG(LOG_WARNING, "TEXT: Text is not valid UTF-8, %i bytes replaced by '?'", (int)invalidBytes);
+
+    layout.glyphs.reserve(codepoints.size());
+
+    float penX = 0.0f;
+    int column = 0;
+    int previous = 0;  // Previous codepoint on the line, 0 at the line start
+
+    for (int codepoint : codepoints) {
+        if (codepoint == '\n') {
+            layout.lineCount++;
+            penX = 0.0f;
+            column = 0;
+            previous = 0;
+            continue;
+        }
+
+        int index = getGlyphIndex(codepoint);
+
+        if (previous != 0) penX += kerning.get(previous, codepoint);
+
+        if ((codepoint != ' ') && (codepoint != '\t')) layout.glyphs.push_back({ codepoint, penX, column, layout.lineCount - 1 });
+
+        if (font.glyphs[index].advanceX == 0)
+            penX += (float)font.recs[index].width;
+        else
+            penX += (float)font.glyphs[index].advanceX;
+
+        column++;
+        previous = codepoint;
+
+        if (penX > layout.maxLineAdvance) layout.maxLineAdvance = penX;
+        if (column > layout.maxLineCodepoints) layout.maxLineCodepoints = column;
+    }
+
+    return layout;
+}
@@ -0,0 +1,205 @@
+#include "Label/TextureArrayAtlas.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "GLState.hpp"
+
+using namespace graphics;
+
+TextureArrayAtlas::TextureArrayAtlas(int width, int height, int maxLayers) : width(width), height(height), maxLayers(maxLayers) {
+    GLint maxTextureLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxTextureLayers);
+    if ((maxTextureLayers > 0) && (this->maxLayers > maxTextureLayers)) {
+        TRACELOG(LOG_WARNING, "TEXTURE: Texture array atlas limited to %i layers", maxTextureLayers);
+        this->maxLayers = maxTextureLayers;
+    }
+
+    glGenTextures(1, &texture);
+    GLState::instance().bindTexture(GL_TEXTURE_2D_ARRAY, texture);
+
+    // Single channel is sampled as alpha, same as GlyphAtlas
+    GLint swizzleMask[] = { GL_ONE, GL_ONE, GL_ONE, GL_RED };
+    glTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    GLState::instance().bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+TextureArrayAtlas::~TextureArrayAtlas() {
+    for (std::unique_ptr<AtlasFont>& atlasFont : fonts) {
+        free(atlasFont->font.glyphs);
+        free(atlasFont->font.recs);
+    }
+
+    GLState::instance().deleteTexture(texture);
+}
+
+int TextureArrayAtlas::addFont(const std::string& fontPath, int fontSize, int fontType, const int* codepoints, int codepointCount) {
+    if (fontType == FONT_MSDF) {
+        TRACELOG(LOG_WARNING, "FONT: [%s] Texture array atlas only holds single channel fonts", fontPath.c_str());
+        return -1;
+    }
+
+    int fileSize = 0;
+    unsigned char* fileData = LoadFileData(fontPath.c_str(), &fileSize);
+    if (fileData == NULL) return -1;
+
+    auto atlasFont = std::make_unique<AtlasFont>();
+    Font& font = atlasFont->font;
+
+    font.baseSize = fontSize;
+    font.glyphCount = (codepointCount > 0) ? codepointCount : 95;
+    font.glyphPadding = 0;
+    font.glyphs = LoadFontData(fileData, fileSize, fontSize, (int*)codepoints, codepointCount, fontType);
+
+    if (font.glyphs == NULL) {
+        free(fileData);
+        return -1;
+    }
+
+    font.recs = (Rectangle*)calloc(font.glyphCount, sizeof(Rectangle));
+    atlasFont->glyphLayers.assign(font.glyphCount, 0);
+
+    for (int i = 0; i < font.glyphCount; i++) {
+        GlyphInfo& glyph = font.glyphs[i];
+
+        // NOTE: Glyphs not available in the font or that don't fit in a layer are left with an empty rectangle
+        if ((glyph.image.data != NULL) && !packGlyph(glyph, &font.recs[i], &atlasFont->glyphLayers[i])) {
+            TRACELOG(LOG_WARNING, "FONT: Texture array atlas is full, failed to add character (%i)", glyph.value);
+        }
+
+        free(glyph.image.data);
+        glyph.image = { 0 };  // Pixels only live in the atlas
+    }
+
+    font.texture.id = texture;
+    font.texture.width = width;
+    font.texture.height = height;
+    font.texture.mipmaps = 1;
+    font.texture.format = PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+
+    // Kerning between every pair of loaded glyphs
+    std::vector<int> glyphCodepoints(font.glyphCount);
+    for (int i = 0; i < font.glyphCount; i++) glyphCodepoints[i] = font.glyphs[i].value;
+
+    int pairCount = 0;
+    KerningPair* pairs = LoadFontKerning(fileData, fileSize, fontSize, glyphCodepoints.data(), font.glyphCount, glyphCodepoints.data(), font.glyphCount, &pairCount);
+    atlasFont->layoutCache = std::make_shared<TextLayoutCache>();
+    atlasFont->layoutCache->kerning.add(pairs, pairCount);
+    free(pairs);
+
+    free(fileData);
+
+    fonts.emplace_back(std::move(atlasFont));
+    TRACELOG(LOG_INFO, "FONT: [%s] Font added to texture array atlas (%i glyphs, %i layers used)", fontPath.c_str(), font.glyphCount, (int)layers.size());
+
+    return (int)fonts.size() - 1;
+}
+
+const TextureArrayAtlas::AtlasFont& TextureArrayAtlas::getFont(int fontId) const {
+    return *fonts[fontId];
+}
+
+int TextureArrayAtlas::fontCount() const {
+    return (int)fonts.size();
+}
+
+int TextureArrayAtlas::layerCount() const {
+    return (int)layers.size();
+}
+
+GLuint TextureArrayAtlas::textureId() const {
+    return texture;
+}
+
+void TextureArrayAtlas::flush() {
+    GLState::instance().bindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    for (int i = 0; i < (int)layers.size(); i++) {
+        Layer& layer = *layers[i];
+        if (layer.dirtyMinY >= layer.dirtyMaxY) continue;
+
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, layer.dirtyMinY, i, width, layer.dirtyMaxY - layer.dirtyMinY, 1, GL_RED, GL_UNSIGNED_BYTE,
+                        layer.pixels.data() + layer.dirtyMinY * width);
+        layer.dirtyMinY = layer.dirtyMaxY = 0;
+    }
+
+    GLState::instance().bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+bool TextureArrayAtlas::addLayer() {
+    if ((int)layers.size() >= maxLayers) return false;
+
+    auto layer = std::make_unique<Layer>();
+    layer->pixels.assign(width * height, 0);
+    layer->packNodes.resize(width);
+    layer->packContext = std::make_unique<stbrp_context>();
+    raylib_stbrp_init_target(layer->packContext.get(), width, height, layer->packNodes.data(), (int)layer->packNodes.size());
+
+    layers.emplace_back(std::move(layer));
+    reserveLayers((int)layers.size());
+
+    return true;
+}
+
+// Glyph goes to the first layer with room for it, a new layer is opened when none has
+bool TextureArrayAtlas::packGlyph(const GlyphInfo& glyph, Rectangle* rec, int* layerIndex) {
+    stbrp_rect rect = { 0 };
+    rect.w = glyph.image.width + 2 * padding;
+    rect.h = glyph.image.height + 2 * padding;
+    if ((rect.w > width) || (rect.h > height)) return false;
+
+    int index = 0;
+    for (; index < (int)layers.size(); index++) {
+        raylib_stbrp_pack_rects(layers[index]->packContext.get(), &rect, 1);
+        if (rect.was_packed) break;
+    }
+
+    if (index == (int)layers.size()) {
+        if (!addLayer()) return false;
+
+        raylib_stbrp_pack_rects(layers[index]->packContext.get(), &rect, 1);
+        if (!rect.was_packed) return false;
+    }
+
+    Layer& layer = *layers[index];
+    int x = rect.x + padding;
+    int y = rect.y + padding;
+
+    for (int row = 0; row < glyph.image.height; row++) {
+        memcpy(&layer.pixels[(y + row) * width + x], (unsigned char*)glyph.image.data + row * glyph.image.width, glyph.image.width);
+    }
+
+    if (layer.dirtyMinY >= layer.dirtyMaxY) {
+        layer.dirtyMinY = y;
+        layer.dirtyMaxY = y + glyph.image.height;
+    } else {
+        layer.dirtyMinY = std::min(layer.dirtyMinY, y);
+        layer.dirtyMaxY = std::max(layer.dirtyMaxY, y + glyph.image.height);
+    }
+
+    *rec = { (float)x, (float)y, (float)glyph.image.width, (float)glyph.image.height };
+    *layerIndex = index;
+
+    return true;
+}
+
+// Reallocating the array drops its contents, every layer is uploaded again on the next flush
+void TextureArrayAtlas::reserveLayers(int count) {
+    if (count <= layerCapacity) return;
+
+    layerCapacity = std::min(std::max(count, layerCapacity * 2), maxLayers);
+
+    GLState::instance().bindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R8, width, height, layerCapacity, 0, GL_RED, GL_UNSIGNED_BYTE, NULL);
+    GLState::instance().bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    for (std::unique_ptr<Layer>& layer : layers) {
+        layer->dirtyMinY = 0;
+        layer->dirtyMaxY = height;
+    }
+}
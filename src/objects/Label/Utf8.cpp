@@ -0,0 +1,294 @@
+#include "Label/Utf8.hpp"
+
+#include <bit>
+
+// UTF8_SCALAR_ONLY leaves the SIMD kernels out, the tests check both builds decode the same way
+#if !defined(UTF8_SCALAR_ONLY) && (defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__))
+#define UTF8_SSE2
+#include <immintrin.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define UTF8_TARGET_AVX2
+#else
+#define UTF8_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+// Block kernels, they only process whole blocks and leave the tail to the scalar loops
+struct Utf8Kernels {
+    const char* name;
+    // Widens leading ASCII bytes into dst, stops at the first multibyte byte, returns bytes widened
+    // NOTE: May write up to one block past the returned count, dst must hold length values
+    size_t (*widenAscii)(const unsigned char* src, size_t length, int* dst);
+    // Bytes before the first multibyte byte
+    size_t (*skipAscii)(const unsigned char* src, size_t length);
+    // Bytes that start a codepoint (everything but 10xxxxxx), processed is set to the bytes counted
+    size_t (*countLeadBytes)(const unsigned char* src, size_t length, size_t* processed);
+};
+
+size_t WidenAsciiScalar(const unsigned char* src, size_t length, int* dst) {
+    size_t i = 0;
+    while ((i < length) && (src[i] < 0x80)) {
+        dst[i] = src[i];
+        i++;
+    }
+
+    return i;
+}
+
+size_t SkipAsciiScalar(const unsigned char* src, size_t length) {
+    size_t i = 0;
+    while ((i < length) && (src[i] < 0x80)) i++;
+
+    return i;
+}
+
+size_t CountLeadBytesScalar(const unsigned char* src, size_t length, size_t* processed) {
+    size_t count = 0;
+    for (size_t i = 0; i < length; i++) count += ((src[i] & 0xc0) != 0x80);
+
+    *processed = length;
+    return count;
+}
+
+#ifdef UTF8_SSE2
+size_t WidenAsciiSse2(const unsigned char* src, size_t length, int* dst) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(src + i));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(bytes);
+
+        // Zero extend 8 -> 16 -> 32 bits, bytes past a multibyte byte are overwritten by the caller
+        __m128i low = _mm_unpacklo_epi8(bytes, zero);
+        __m128i high = _mm_unpackhi_epi8(bytes, zero);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi16(low, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 4), _mm_unpackhi_epi16(low, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpacklo_epi16(high, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 12), _mm_unpackhi_epi16(high, zero));
+
+        if (mask != 0) return i + std::countr_zero(mask);
+    }
+
+    return i;
+}
+
+size_t SkipAsciiSse2(const unsigned char* src, size_t length) {
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(src + i)));
+        if (mask != 0) return i + std::countr_zero(mask);
+    }
+
+    return i;
+}
+
+size_t CountLeadBytesSse2(const unsigned char* src, size_t length, size_t* processed) {
+    // Continuation bytes 0x80-0xbf are the signed bytes below -64
+    const __m128i threshold = _mm_set1_epi8(-64);
+    size_t count = 0;
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(src + i));
+        unsigned int continuation = (unsigned int)_mm_movemask_epi8(_mm_cmplt_epi8(bytes, threshold));
+        count += 16 - std::popcount(continuation);
+    }
+
+    *processed = i;
+    return count;
+}
+
+UTF8_TARGET_AVX2 size_t WidenAsciiAvx2(const unsigned char* src, size_t length, int* dst) {
+    size_t i = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)(src + i)));
+
+        for (size_t j = 0; j < 32; j += 8) {
+            __m128i bytes = _mm_loadl_epi64((const __m128i*)(src + i + j));
+            _mm256_storeu_si256((__m256i*)(dst + i + j), _mm256_cvtepu8_epi32(bytes));
+        }
+
+        if (mask != 0) return i + std::countr_zero(mask);
+    }
+
+    return i;
+}
+
+UTF8_TARGET_AVX2 size_t SkipAsciiAvx2(const unsigned char* src, size_t length) {
+    size_t i = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)(src + i)));
+        if (mask != 0) return i + std::countr_zero(mask);
+    }
+
+    return i;
+}
+
+UTF8_TARGET_AVX2 size_t CountLeadBytesAvx2(const unsigned char* src, size_t length, size_t* processed) {
+    const __m256i threshold = _mm256_set1_epi8(-64);
+    size_t count = 0;
+    size_t i = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i*)(src + i));
+        unsigned int continuation = (unsigned int)_mm256_movemask_epi8(_mm256_cmpgt_epi8(threshold, bytes));
+        count += 32 - std::popcount(continuation);
+    }
+
+    *processed = i;
+    return count;
+}
+
+bool CpuSupportsAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    // OS must save the YMM registers (OSXSAVE + XCR0 bits 1 and 2)
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+const Utf8Kernels& GetKernels() {
+    static const Utf8Kernels kernels = []() -> Utf8Kernels {
+#ifdef UTF8_SSE2
+        if (CpuSupportsAvx2()) return { "AVX2", WidenAsciiAvx2, SkipAsciiAvx2, CountLeadBytesAvx2 };
+        return { "SSE2", WidenAsciiSse2, SkipAsciiSse2, CountLeadBytesSse2 };
+#else
+        return { "scalar", WidenAsciiScalar, SkipAsciiScalar, CountLeadBytesScalar };
+#endif
+    }();
+
+    return kernels;
+}
+
+// Decodes the multibyte sequence at src, returns its size or 0 when it is not well formed
+size_t DecodeSequence(const unsigned char* src, size_t length, int* codepoint) {
+    size_t size = 0;
+    int value = 0;
+    int minimum = 0;  // Smaller values are overlong encodings
+
+    if ((src[0] & 0xe0) == 0xc0) {
+        size = 2;
+        value = src[0] & 0x1f;
+        minimum = 0x80;
+    } else if ((src[0] & 0xf0) == 0xe0) {
+        size = 3;
+        value = src[0] & 0x0f;
+        minimum = 0x800;
+    } else if ((src[0] & 0xf8) == 0xf0) {
+        size = 4;
+        value = src[0] & 0x07;
+        minimum = 0x10000;
+    } else {
+        return 0;
+    }
+
+    if (size > length) return 0;
+
+    for (size_t i = 1; i < size; i++) {
+        if ((src[i] & 0xc0) != 0x80) return 0;
+        value = (value << 6) | (src[i] & 0x3f);
+    }
+
+    if ((value < minimum) || (value > 0x10ffff) || ((value >= 0xd800) && (value <= 0xdfff))) return 0;
+
+    *codepoint = value;
+    return size;
+}
+
+}  // namespace
+
+size_t DecodeUtf8(const char* text, size_t length, std::vector<int>& codepoints) {
+    if ((text == NULL) || (length == 0)) return 0;
+
+    const Utf8Kernels& kernels = GetKernels();
+    const unsigned char* src = (const unsigned char*)text;
+
+    // Every byte decodes to one codepoint at most
+    size_t first = codepoints.size();
+    codepoints.resize(first + length);
+    int* dst = codepoints.data() + first;
+
+    size_t invalidBytes = 0;
+
+    for (size_t i = 0; i < length;) {
+        if (src[i] < 0x80) {
+            size_t ascii = kernels.widenAscii(src + i, length - i, dst);
+            ascii += WidenAsciiScalar(src + i + ascii, length - i - ascii, dst + ascii);
+
+            dst += ascii;
+            i += ascii;
+        } else {
+            int codepoint = 0;
+            size_t size = DecodeSequence(src + i, length - i, &codepoint);
+
+            if (size == 0) {
+                codepoint = '?';
+                size = 1;
+                invalidBytes++;
+            }
+
+            *dst++ = codepoint;
+            i += size;
+        }
+    }
+
+    codepoints.resize(dst - codepoints.data());
+
+    return invalidBytes;
+}
+
+bool ValidateUtf8(const char* text, size_t length) {
+    if (text == NULL) return length == 0;
+
+    const Utf8Kernels& kernels = GetKernels();
+    const unsigned char* src = (const unsigned char*)text;
+
+    for (size_t i = 0; i < length;) {
+        if (src[i] < 0x80) {
+            size_t ascii = kernels.skipAscii(src + i, length - i);
+            i += ascii + SkipAsciiScalar(src + i + ascii, length - i - ascii);
+        } else {
+            int codepoint = 0;
+            size_t size = DecodeSequence(src + i, length - i, &codepoint);
+            if (size == 0) return false;
+
+            i += size;
+        }
+    }
+
+    return true;
+}
+
+size_t CountUtf8Codepoints(const char* text, size_t length) {
+    if (text == NULL) return 0;
+
+    const unsigned char* src = (const unsigned char*)text;
+
+    size_t processed = 0;
+    size_t count = GetKernels().countLeadBytes(src, length, &processed);
+
+    return count + CountLeadBytesScalar(src + processed, length - processed, &processed);
+}
+
+const char* GetUtf8KernelName() {
+    return GetKernels().name;
+}
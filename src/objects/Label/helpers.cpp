@@ -6,7 +6,17 @@
 #include <stdlib.h>  // Required for: exit()
 #include <string.h>  // Required for: strcpy(), strcat()
 
+#include <atomic>  // Required for: std::atomic
+#include <thread>  // Required for: std::thread
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "GLState.hpp"
 #include "Label/helpers.hpp"
+#ifdef GRAPHICS_FREETYPE
+#include "Label/FreeTypeFont.hpp"
+#endif
 #define STB_RECT_PACK_IMPLEMENTATION
 #include "stb_rect_pack.h"
 //
@@ -14,6 +24,11 @@
 #define STBTT_STATIC
 #define STB_TRUETYPE_IMPLEMENTATION
 #include "stb_truetype.h"  // Required for: ttf font data reading
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+#define FONT_SDF_SSE2
+#include <emmintrin.h>  // Required for: SDF distance transform kernels
+#endif
 //
 #include "math/Vector2.hpp"
 
@@ -162,22 +177,578 @@ unsigned char *LoadFileData(const char *fileName, int *dataSize) {
     return data;
 }
 
-// Load font data for further use
-// NOTE: Requires TTF font memory data and can generate SDF data
-GlyphInfo *LoadFontData(const unsigned char *fileData, int dataSize, int fontSize, int *codepoints, int codepointCount, int type) {
-    // NOTE: Using some SDF generation default values,
-    // trades off precision with ability to handle *smaller* sizes
-#ifndef FONT_SDF_CHAR_PADDING
-#define FONT_SDF_CHAR_PADDING 4  // SDF font generation char padding
+#if FONT_SDF_SUPERSAMPLE > 0
+// Column pass of the distance transform: row = min(row, neighbour + 1)
+static void DistanceTransformColumns(float *row, const float *neighbour, int width) {
+    int x = 0;
+#ifdef FONT_SDF_SSE2
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; x + 4 <= width; x += 4) _mm_storeu_ps(row + x, _mm_min_ps(_mm_loadu_ps(row + x), _mm_add_ps(_mm_loadu_ps(neighbour + x), one)));
+#endif
+    for (; x < width; x++) row[x] = (neighbour[x] + 1.0f < row[x]) ? neighbour[x] + 1.0f : row[x];
+}
+
+// Row pass of the distance transform (lower envelope of parabolas, Felzenszwalb & Huttenlocher), row holds the
+// column distances and gets the squared euclidean distances. Only columns sampled by the output are written:
+// samples consecutive columns starting at offset in every block of step columns
+// NOTE: parabolas and envelope must hold width + 1 values, squared must hold width values
+static void DistanceTransformRow(float *row, int width, int step, int offset, int samples, int *parabolas, float *envelope, float *squared) {
+    int x = 0;
+#ifdef FONT_SDF_SSE2
+    for (; x + 4 <= width; x += 4) {
+        __m128 value = _mm_loadu_ps(row + x);
+        _mm_storeu_ps(squared + x, _mm_mul_ps(value, value));
+    }
 #endif
-#ifndef FONT_SDF_ON_EDGE_VALUE
-#define FONT_SDF_ON_EDGE_VALUE 128  // SDF font generation on edge value
+    for (; x < width; x++) squared[x] = row[x] * row[x];
+
+    int k = 0;
+    parabolas[0] = 0;
+    envelope[0] = -1e30f;
+    envelope[1] = 1e30f;
+
+    for (int q = 1; q < width; q++) {
+        // Intersection with the rightmost parabola of the envelope, drop the ones hidden by q
+        float s = 0.0f;
+        for (;;) {
+            int v = parabolas[k];
+            s = ((squared[q] + (float)(q * q)) - (squared[v] + (float)(v * v))) / (float)(2 * (q - v));
+            if (s > envelope[k]) break;
+            k--;
+        }
+
+        k++;
+        parabolas[k] = q;
+        envelope[k] = s;
+        envelope[k + 1] = 1e30f;
+    }
+
+    k = 0;
+    for (int block = 0; block < width; block += step) {
+        for (int q = block + offset; q < block + offset + samples; q++) {
+            while (envelope[k + 1] < (float)q) k++;
+
+            float dx = (float)(q - parabolas[k]);
+            row[q] = dx * dx + squared[parabolas[k]];
+        }
+    }
+}
+
+// Same output as stbtt_GetCodepointSDF() (size, offsets and onEdgeValue/pixelDistScale encoding) computed with a
+// linear time distance transform of a FONT_SDF_SUPERSAMPLE times bigger bitmap, instead of measuring the distance
+// of every pixel to every glyph edge
+static unsigned char *LoadGlyphSDF(const stbtt_fontinfo *fontInfo, float scale, int glyph, int padding, unsigned char onEdgeValue, float pixelDistScale, int *width, int *height, int *xoff, int *yoff) {
+    const int supersample = FONT_SDF_SUPERSAMPLE;
+
+    int ix0 = 0, iy0 = 0, ix1 = 0, iy1 = 0;
+    stbtt_GetGlyphBitmapBox(fontInfo, glyph, scale, scale, &ix0, &iy0, &ix1, &iy1);
+    if ((scale == 0.0f) || (ix0 == ix1) || (iy0 == iy1)) return NULL;
+
+    int w = (ix1 - ix0) + 2 * padding;
+    int h = (iy1 - iy0) + 2 * padding;
+    int bigWidth = w * supersample;
+    int bigHeight = h * supersample;
+
+    // Rasterize the glyph at the supersampled scale, aligned with the output box
+    int bx0 = 0, by0 = 0, bx1 = 0, by1 = 0;
+    stbtt_GetGlyphBitmapBox(fontInfo, glyph, scale * supersample, scale * supersample, &bx0, &by0, &bx1, &by1);
+
+    int offsetX = bx0 - (ix0 - padding) * supersample;
+    int offsetY = by0 - (iy0 - padding) * supersample;
+    offsetX = (offsetX < 0) ? 0 : offsetX;
+    offsetY = (offsetY < 0) ? 0 : offsetY;
+    int renderWidth = ((bx1 - bx0) < (bigWidth - offsetX)) ? (bx1 - bx0) : (bigWidth - offsetX);
+    int renderHeight = ((by1 - by0) < (bigHeight - offsetY)) ? (by1 - by0) : (bigHeight - offsetY);
+
+    std::vector<unsigned char> coverage(bigWidth * bigHeight);
+    stbtt_MakeGlyphBitmap(fontInfo, coverage.data() + offsetY * bigWidth + offsetX, renderWidth, renderHeight, bigWidth, scale * supersample, scale * supersample, glyph);
+
+    // Pixels with a neighbour on the other side of the outline are half a pixel away from it,
+    // every other pixel gets its distance to the closest of them
+    const float far = (float)(bigWidth + bigHeight);
+    std::vector<float> distance(bigWidth * bigHeight);
+
+    for (int y = 0; y < bigHeight; y++) {
+        for (int x = 0; x < bigWidth; x++) {
+            bool inside = (coverage[y * bigWidth + x] >= 128);
+            bool edge = (((x > 0) && ((coverage[y * bigWidth + x - 1] >= 128) != inside)) ||
+                         ((x < bigWidth - 1) && ((coverage[y * bigWidth + x + 1] >= 128) != inside)) ||
+                         ((y > 0) && ((coverage[(y - 1) * bigWidth + x] >= 128) != inside)) ||
+                         ((y < bigHeight - 1) && ((coverage[(y + 1) * bigWidth + x] >= 128) != inside)));
+
+            distance[y * bigWidth + x] = edge ? 0.0f : far;
+        }
+    }
+
+    // Columns are swept a whole row at a time (vectorized across columns)
+    for (int y = 1; y < bigHeight; y++) DistanceTransformColumns(&distance[y * bigWidth], &distance[(y - 1) * bigWidth], bigWidth);
+    for (int y = bigHeight - 2; y >= 0; y--) DistanceTransformColumns(&distance[y * bigWidth], &distance[(y + 1) * bigWidth], bigWidth);
+
+    // Output pixel centers fall in the middle of a block: one sample per block when supersample is odd,
+    // the 2x2 samples around it when it is even. Only those rows and columns need the row pass
+    const int samples = (supersample % 2 == 0) ? 2 : 1;
+    const int sampleOffset = (supersample - samples) / 2;
+
+    int maxSide = (bigWidth > bigHeight) ? bigWidth : bigHeight;
+    std::vector<int> parabolas(maxSide + 1);
+    std::vector<float> envelope(maxSide + 1);
+    std::vector<float> squared(maxSide);
+
+    for (int y = 0; y < h; y++) {
+        for (int sy = 0; sy < samples; sy++) {
+            float *row = &distance[(y * supersample + sampleOffset + sy) * bigWidth];
+            DistanceTransformRow(row, bigWidth, supersample, sampleOffset, samples, parabolas.data(), envelope.data(), squared.data());
+        }
+    }
+
+    // Signed distance (positive inside) converted back to output pixels
+    unsigned char *data = (unsigned char *)malloc(w * h);
+    const float sampleScale = 1.0f / (float)(samples * samples * supersample);
+
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            float sum = 0.0f;
+            for (int sy = 0; sy < samples; sy++) {
+                for (int sx = 0; sx < samples; sx++) {
+                    int i = (y * supersample + sampleOffset + sy) * bigWidth + x * supersample + sampleOffset + sx;
+                    float d = sqrtf(distance[i]) + 0.5f;
+                    sum += (coverage[i] >= 128) ? d : -d;
+                }
+            }
+
+            float value = (float)onEdgeValue + sum * sampleScale * pixelDistScale;
+            data[y * w + x] = (unsigned char)((value < 0.0f) ? 0.0f : (value > 255.0f) ? 255.0f : value);
+        }
+    }
+
+    *width = w;
+    *height = h;
+    *xoff = ix0 - padding;
+    *yoff = iy0 - padding;
+
+    return data;
+}
 #endif
-#ifndef FONT_SDF_PIXEL_DIST_SCALE
-#define FONT_SDF_PIXEL_DIST_SCALE 64.0f  // SDF font generation pixel distance scale
+
+// Multi-channel SDF generation (FONT_MSDF)
+//----------------------------------------------------------------------------------
+// Edge colors, every channel of a pixel stores the distance to the closest edge having that channel.
+// Edges meeting at a corner never share two channels, so the median of the channels keeps the corner sharp
+#define MSDF_RED 1
+#define MSDF_GREEN 2
+#define MSDF_BLUE 4
+#define MSDF_YELLOW (MSDF_RED | MSDF_GREEN)
+#define MSDF_MAGENTA (MSDF_RED | MSDF_BLUE)
+#define MSDF_CYAN (MSDF_GREEN | MSDF_BLUE)
+#define MSDF_WHITE (MSDF_RED | MSDF_GREEN | MSDF_BLUE)
+
+#define MSDF_CORNER_CROSS_THRESHOLD 0.141f  // sin(3 rad), smaller direction changes are not corners
+#define MSDF_CURVE_SAMPLES 8                // Coarse samples before refining the closest point of a curve
+
+typedef struct MsdfPoint {
+    float x, y;
+} MsdfPoint;
+
+// Contour segment in output pixel coordinates: line (degree 1), quadratic (2) or cubic (3) bezier
+typedef struct MsdfEdge {
+    MsdfPoint p[4];
+    int degree;
+    int color;
+} MsdfEdge;
+
+typedef struct MsdfDistance {
+    float distance;  // Signed by the side of the edge the point is on
+    float dot;       // |cos| between edge direction and point direction, breaks ties at shared endpoints
+    float param;     // Closest point parameter on the edge
+} MsdfDistance;
+
+static inline MsdfPoint MsdfAdd(MsdfPoint a, MsdfPoint b) { return { a.x + b.x, a.y + b.y }; }
+static inline MsdfPoint MsdfSub(MsdfPoint a, MsdfPoint b) { return { a.x - b.x, a.y - b.y }; }
+static inline MsdfPoint MsdfScale(MsdfPoint a, float s) { return { a.x * s, a.y * s }; }
+static inline float MsdfDot(MsdfPoint a, MsdfPoint b) { return a.x * b.x + a.y * b.y; }
+static inline float MsdfCross(MsdfPoint a, MsdfPoint b) { return a.x * b.y - a.y * b.x; }
+
+static inline MsdfPoint MsdfNormalize(MsdfPoint a) {
+    float length = sqrtf(MsdfDot(a, a));
+    return (length > 0.0f) ? MsdfScale(a, 1.0f / length) : MsdfPoint{ 0.0f, 1.0f };
+}
+
+static MsdfPoint MsdfEdgePoint(const MsdfEdge *edge, float t) {
+    const MsdfPoint *p = edge->p;
+    float s = 1.0f - t;
+
+    switch (edge->degree) {
+        case 1:
+            return MsdfAdd(MsdfScale(p[0], s), MsdfScale(p[1], t));
+        case 2:
+            return MsdfAdd(MsdfAdd(MsdfScale(p[0], s * s), MsdfScale(p[1], 2.0f * s * t)), MsdfScale(p[2], t * t));
+        default:
+            return MsdfAdd(MsdfAdd(MsdfScale(p[0], s * s * s), MsdfScale(p[1], 3.0f * s * s * t)), MsdfAdd(MsdfScale(p[2], 3.0f * s * t * t), MsdfScale(p[3], t * t * t)));
+    }
+}
+
+static MsdfPoint MsdfEdgeDirection(const MsdfEdge *edge, float t) {
+    const MsdfPoint *p = edge->p;
+    float s = 1.0f - t;
+    MsdfPoint direction = { 0 };
+
+    switch (edge->degree) {
+        case 1:
+            direction = MsdfSub(p[1], p[0]);
+            break;
+        case 2:
+            direction = MsdfScale(MsdfAdd(MsdfScale(MsdfSub(p[1], p[0]), s), MsdfScale(MsdfSub(p[2], p[1]), t)), 2.0f);
+            break;
+        default:
+            direction = MsdfScale(MsdfAdd(MsdfAdd(MsdfScale(MsdfSub(p[1], p[0]), s * s), MsdfScale(MsdfSub(p[2], p[1]), 2.0f * s * t)), MsdfScale(MsdfSub(p[3], p[2]), t * t)), 3.0f);
+            break;
+    }
+
+    // Control point on top of an endpoint, use the chord
+    if (MsdfDot(direction, direction) == 0.0f) direction = MsdfSub(p[edge->degree], p[0]);
+
+    return direction;
+}
+
+static MsdfPoint MsdfEdgeSecondDerivative(const MsdfEdge *edge, float t) {
+    const MsdfPoint *p = edge->p;
+
+    switch (edge->degree) {
+        case 1:
+            return { 0.0f, 0.0f };
+        case 2:
+            return MsdfScale(MsdfAdd(MsdfSub(p[2], MsdfScale(p[1], 2.0f)), p[0]), 2.0f);
+        default: {
+            MsdfPoint a = MsdfAdd(MsdfSub(p[2], MsdfScale(p[1], 2.0f)), p[0]);
+            MsdfPoint b = MsdfAdd(MsdfSub(p[3], MsdfScale(p[2], 2.0f)), p[1]);
+            return MsdfScale(MsdfAdd(MsdfScale(a, 1.0f - t), MsdfScale(b, t)), 6.0f);
+        }
+    }
+}
+
+// Splits an edge in two halves (de Casteljau)
+static void MsdfSplitEdge(const MsdfEdge *edge, MsdfEdge *first, MsdfEdge *second) {
+    MsdfPoint points[4][4] = { 0 };
+    for (int i = 0; i <= edge->degree; i++) points[0][i] = edge->p[i];
+
+    for (int level = 1; level <= edge->degree; level++) {
+        for (int i = 0; i <= edge->degree - level; i++) points[level][i] = MsdfScale(MsdfAdd(points[level - 1][i], points[level - 1][i + 1]), 0.5f);
+    }
+
+    *first = *edge;
+    *second = *edge;
+    for (int i = 0; i <= edge->degree; i++) {
+        first->p[i] = points[i][0];
+        second->p[i] = points[edge->degree - i][i];
+    }
+}
+
+static MsdfDistance MsdfEdgeDistance(const MsdfEdge *edge, MsdfPoint point) {
+    float t = 0.0f;
+
+    if (edge->degree == 1) {
+        MsdfPoint chord = MsdfSub(edge->p[1], edge->p[0]);
+        float length = MsdfDot(chord, chord);
+        t = (length > 0.0f) ? MsdfDot(MsdfSub(point, edge->p[0]), chord) / length : 0.0f;
+    } else {
+        // Closest sample, then Newton iterations on dot(B(t) - point, B'(t)) = 0
+        float closest = 1e30f;
+        for (int i = 0; i <= MSDF_CURVE_SAMPLES; i++) {
+            float sampleT = (float)i / MSDF_CURVE_SAMPLES;
+            MsdfPoint v = MsdfSub(MsdfEdgePoint(edge, sampleT), point);
+            if (MsdfDot(v, v) < closest) {
+                closest = MsdfDot(v, v);
+                t = sampleT;
+            }
+        }
+
+        for (int i = 0; i < 4; i++) {
+            MsdfPoint v = MsdfSub(MsdfEdgePoint(edge, t), point);
+            MsdfPoint d1 = MsdfEdgeDirection(edge, t);
+            float slope = MsdfDot(d1, d1) + MsdfDot(v, MsdfEdgeSecondDerivative(edge, t));
+            if (slope <= 0.0f) break;
+
+            t -= MsdfDot(v, d1) / slope;
+            t = (t < 0.0f) ? 0.0f : (t > 1.0f) ? 1.0f : t;
+        }
+    }
+
+    t = (t < 0.0f) ? 0.0f : (t > 1.0f) ? 1.0f : t;
+
+    MsdfPoint direction = MsdfEdgeDirection(edge, t);
+    MsdfPoint v = MsdfSub(point, MsdfEdgePoint(edge, t));
+    float distance = sqrtf(MsdfDot(v, v));
+
+    MsdfDistance result = { 0 };
+    result.distance = (MsdfCross(direction, v) >= 0.0f) ? distance : -distance;
+    result.dot = (distance > 0.0f) ? fabsf(MsdfDot(MsdfNormalize(direction), MsdfScale(v, 1.0f / distance))) : 0.0f;
+    result.param = t;
+
+    return result;
+}
+
+static inline bool MsdfCloser(MsdfDistance a, MsdfDistance b) {
+    float difference = fabsf(a.distance) - fabsf(b.distance);
+    return (difference < -1e-5f) || ((difference <= 1e-5f) && (a.dot < b.dot));
+}
+
+// Distance to the edge extended along its end tangents, keeps the channels straight past corners
+static float MsdfPseudoDistance(const MsdfEdge *edge, MsdfPoint point, MsdfDistance distance) {
+    if ((distance.param <= 0.0f) || (distance.param >= 1.0f)) {
+        float t = (distance.param <= 0.0f) ? 0.0f : 1.0f;
+        MsdfPoint direction = MsdfNormalize(MsdfEdgeDirection(edge, t));
+        MsdfPoint v = MsdfSub(point, MsdfEdgePoint(edge, t));
+        float along = MsdfDot(v, direction);
+
+        if ((t == 0.0f) ? (along < 0.0f) : (along > 0.0f)) {
+            float pseudoDistance = MsdfCross(direction, v);
+            if (fabsf(pseudoDistance) <= fabsf(distance.distance)) return pseudoDistance;
+        }
+    }
+
+    return distance.distance;
+}
+
+// Assigns colors to the edges of a closed contour, splitting edges when a single corner needs three colors
+static void MsdfColorContour(std::vector<MsdfEdge> &edges) {
+    std::vector<int> corners;
+    for (int i = 0; i < (int)edges.size(); i++) {
+        const MsdfEdge *previous = &edges[(i + edges.size() - 1) % edges.size()];
+        MsdfPoint a = MsdfNormalize(MsdfEdgeDirection(previous, 1.0f));
+        MsdfPoint b = MsdfNormalize(MsdfEdgeDirection(&edges[i], 0.0f));
+
+        if ((MsdfDot(a, b) <= 0.0f) || (fabsf(MsdfCross(a, b)) > MSDF_CORNER_CROSS_THRESHOLD)) corners.push_back(i);
+    }
+
+    if (corners.empty()) {
+        // Smooth contour, every channel follows it
+        for (MsdfEdge &edge : edges) edge.color = MSDF_WHITE;
+    } else if (corners.size() == 1) {
+        // Teardrop: the two sides of the corner get different colors, with white in between
+        while (edges.size() < 3) {
+            std::vector<MsdfEdge> split;
+            for (const MsdfEdge &edge : edges) {
+                MsdfEdge first, second;
+                MsdfSplitEdge(&edge, &first, &second);
+                split.push_back(first);
+                split.push_back(second);
+            }
+            edges.swap(split);
+            corners[0] *= 2;
+        }
+
+        const int colors[3] = { MSDF_MAGENTA, MSDF_WHITE, MSDF_YELLOW };
+        int count = (int)edges.size();
+        for (int i = 0; i < count; i++) edges[(corners[0] + i) % count].color = colors[(3 * i) / count];
+    } else {
+        // Colors cycle at every corner, the last spline can't take the color of the first one
+        const int colors[3] = { MSDF_CYAN, MSDF_MAGENTA, MSDF_YELLOW };
+        int splineCount = (int)corners.size();
+        int count = (int)edges.size();
+
+        for (int i = 0, spline = -1; i < count; i++) {
+            int index = (corners[0] + i) % count;
+            if ((spline + 1 < splineCount) && (index == corners[spline + 1])) spline++;
+
+            int color = colors[spline % 3];
+            if ((spline == splineCount - 1) && (spline % 3 == 0)) color = colors[1];
+            edges[index].color = color;
+        }
+    }
+}
+
+// Multi-channel SDF of a glyph, same size, offsets and onEdgeValue/pixelDistScale encoding as
+// stbtt_GetCodepointSDF(): the shape is read from the outline, so corners stay sharp at small sizes
+static unsigned char *LoadGlyphMSDF(const stbtt_fontinfo *fontInfo, float scale, int glyph, int padding, unsigned char onEdgeValue, float pixelDistScale, int *width, int *height, int *xoff, int *yoff) {
+    int ix0 = 0, iy0 = 0, ix1 = 0, iy1 = 0;
+    stbtt_GetGlyphBitmapBox(fontInfo, glyph, scale, scale, &ix0, &iy0, &ix1, &iy1);
+    if ((scale == 0.0f) || (ix0 == ix1) || (iy0 == iy1)) return NULL;
+
+    int w = (ix1 - ix0) + 2 * padding;
+    int h = (iy1 - iy0) + 2 * padding;
+
+    // Outline in output pixel coordinates (y down), contours are closed
+    stbtt_vertex *vertices = NULL;
+    int vertexCount = stbtt_GetGlyphShape(fontInfo, glyph, &vertices);
+
+    const float originX = (float)(ix0 - padding);
+    const float originY = (float)(iy0 - padding);
+    auto toPixels = [&](float x, float y) -> MsdfPoint { return { x * scale - originX, -y * scale - originY }; };
+
+    std::vector<MsdfEdge> edges;
+    std::vector<MsdfEdge> contour;
+    MsdfPoint start = { 0 }, current = { 0 };
+
+    auto closeContour = [&]() {
+        if ((current.x != start.x) || (current.y != start.y)) contour.push_back({ { current, start }, 1, MSDF_WHITE });
+        if (!contour.empty()) {
+            MsdfColorContour(contour);
+            edges.insert(edges.end(), contour.begin(), contour.end());
+        }
+        contour.clear();
+    };
+
+    for (int i = 0; i < vertexCount; i++) {
+        const stbtt_vertex *v = &vertices[i];
+        MsdfPoint point = toPixels(v->x, v->y);
+
+        switch (v->type) {
+            case STBTT_vmove:
+                closeContour();
+                start = point;
+                break;
+            case STBTT_vline:
+                if ((point.x != current.x) || (point.y != current.y)) contour.push_back({ { current, point }, 1, MSDF_WHITE });
+                break;
+            case STBTT_vcurve:
+                contour.push_back({ { current, toPixels(v->cx, v->cy), point }, 2, MSDF_WHITE });
+                break;
+            case STBTT_vcubic:
+                contour.push_back({ { current, toPixels(v->cx, v->cy), toPixels(v->cx1, v->cy1), point }, 3, MSDF_WHITE });
+                break;
+            default:
+                break;
+        }
+
+        current = point;
+    }
+    closeContour();
+
+    stbtt_FreeShape(fontInfo, vertices);
+
+    if (edges.empty()) return NULL;
+
+    // Inside is on the left of the edges when the control polygon area is positive
+    float area = 0.0f;
+    for (const MsdfEdge &edge : edges) {
+        for (int i = 0; i < edge.degree; i++) area += MsdfCross(edge.p[i], edge.p[i + 1]);
+    }
+    const float orientation = (area > 0.0f) ? 1.0f : -1.0f;
+
+    unsigned char *data = (unsigned char *)malloc(w * h * 3);
+
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            MsdfPoint point = { (float)x + 0.5f, (float)y + 0.5f };
+
+            MsdfDistance closest[3] = { { 1e30f, 1.0f, 0.0f }, { 1e30f, 1.0f, 0.0f }, { 1e30f, 1.0f, 0.0f } };
+            const MsdfEdge *closestEdge[3] = { NULL, NULL, NULL };
+
+            for (const MsdfEdge &edge : edges) {
+                MsdfDistance distance = MsdfEdgeDistance(&edge, point);
+
+                for (int channel = 0; channel < 3; channel++) {
+                    if ((edge.color & (1 << channel)) && MsdfCloser(distance, closest[channel])) {
+                        closest[channel] = distance;
+                        closestEdge[channel] = &edge;
+                    }
+                }
+            }
+
+            for (int channel = 0; channel < 3; channel++) {
+                float distance = (closestEdge[channel] != NULL) ? MsdfPseudoDistance(closestEdge[channel], point, closest[channel]) : -1e30f;
+                float value = (float)onEdgeValue + orientation * distance * pixelDistScale;
+                data[(y * w + x) * 3 + channel] = (unsigned char)((value < 0.0f) ? 0.0f : (value > 255.0f) ? 255.0f : value);
+            }
+        }
+    }
+
+    *width = w;
+    *height = h;
+    *xoff = ix0 - padding;
+    *yoff = iy0 - padding;
+
+    return data;
+}
+
+// Generate a single glyph image and metrics
+// NOTE: Only reads fontInfo, it is safe to call it concurrently for different glyphs
+static void LoadGlyphData(const stbtt_fontinfo *fontInfo, float scaleFactor, int ascent, int fontSize, int ch, int type, GlyphInfo *glyph) {
+    int chw = 0, chh = 0;  // Character width and height (on generation)
+    glyph->value = ch;
+
+    //  Render a unicode codepoint to a bitmap
+    //      stbtt_GetCodepointBitmap()           -- allocates and returns a bitmap
+    //      stbtt_GetCodepointBitmapBox()        -- how big the bitmap must be
+    //      stbtt_MakeCodepointBitmap()          -- renders into bitmap you provide
+
+    // Check if a glyph is available in the font
+    // WARNING: if (index == 0), glyph not found, it could fallback to default .notdef glyph (if defined in font)
+    int index = stbtt_FindGlyphIndex(fontInfo, ch);
+
+    if (index > 0) {
+        switch (type) {
+            case FONT_DEFAULT:
+            case FONT_BITMAP:
+                glyph->image.data = stbtt_GetCodepointBitmap(fontInfo, scaleFactor, scaleFactor, ch, &chw, &chh, &glyph->offsetX, &glyph->offsetY);
+                break;
+            case FONT_SDF:
+#if FONT_SDF_SUPERSAMPLE > 0
+                if (ch != 32) glyph->image.data = LoadGlyphSDF(fontInfo, scaleFactor, index, FONT_SDF_CHAR_PADDING, FONT_SDF_ON_EDGE_VALUE, FONT_SDF_PIXEL_DIST_SCALE, &chw, &chh, &glyph->offsetX, &glyph->offsetY);
+#else
+                if (ch != 32) glyph->image.data = stbtt_GetCodepointSDF(fontInfo, scaleFactor, ch, FONT_SDF_CHAR_PADDING, FONT_SDF_ON_EDGE_VALUE, FONT_SDF_PIXEL_DIST_SCALE, &chw, &chh, &glyph->offsetX, &glyph->offsetY);
 #endif
-#ifndef FONT_BITMAP_ALPHA_THRESHOLD
-#define FONT_BITMAP_ALPHA_THRESHOLD 80  // Bitmap (B&W) font generation alpha threshold
+                break;
+            case FONT_MSDF:
+                if (ch != 32) glyph->image.data = LoadGlyphMSDF(fontInfo, scaleFactor, index, FONT_SDF_CHAR_PADDING, FONT_SDF_ON_EDGE_VALUE, FONT_SDF_PIXEL_DIST_SCALE, &chw, &chh, &glyph->offsetX, &glyph->offsetY);
+                break;
+            default:
+                break;
+        }
+
+        if (glyph->image.data != NULL)  // Glyph data has been found in the font
+        {
+            stbtt_GetCodepointHMetrics(fontInfo, ch, &glyph->advanceX, NULL);
+            glyph->advanceX = (int)((float)glyph->advanceX * scaleFactor);
+
+            // Load characters images
+            glyph->image.width = chw;
+            glyph->image.height = chh;
+            glyph->image.mipmaps = 1;
+            glyph->image.format = (type == FONT_MSDF) ? PIXELFORMAT_UNCOMPRESSED_R8G8B8 : PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+
+            glyph->offsetY += (int)((float)ascent * scaleFactor);
+        }
+
+        // NOTE: We create an empty image for space character,
+        // it could be further required for atlas packing
+        if (ch == 32) {
+            stbtt_GetCodepointHMetrics(fontInfo, ch, &glyph->advanceX, NULL);
+            glyph->advanceX = (int)((float)glyph->advanceX * scaleFactor);
+
+            Image imSpace = {
+                .data = calloc(glyph->advanceX * fontSize, (type == FONT_MSDF) ? 3 : 2),
+                .width = glyph->advanceX,
+                .height = fontSize,
+                .mipmaps = 1,
+                .format = (type == FONT_MSDF) ? PIXELFORMAT_UNCOMPRESSED_R8G8B8 : PIXELFORMAT_UNCOMPRESSED_GRAYSCALE
+            };
+
+            glyph->image = imSpace;
+        }
+
+        if (type == FONT_BITMAP) {
+            // Aliased bitmap (black & white) font generation, avoiding anti-aliasing
+            // NOTE: For optimum results, bitmap font should be generated at base pixel size
+            for (int p = 0; p < chw * chh; p++) {
+                if (((unsigned char *)glyph->image.data)[p] < FONT_BITMAP_ALPHA_THRESHOLD)
+                    ((unsigned char *)glyph->image.data)[p] = 0;
+                else
+                    ((unsigned char *)glyph->image.data)[p] = 255;
+            }
+        }
+    } else {
+        // TODO: Use some fallback glyph for codepoints not found in the font
+    }
+}
+
+// Load font data for further use
+// NOTE: Requires TTF font memory data and can generate SDF data
+GlyphInfo *LoadFontData(const unsigned char *fileData, int dataSize, int fontSize, int *codepoints, int codepointCount, int type) {
+#ifdef GRAPHICS_FREETYPE
+    // FreeType builds rasterize glyphs through the glyph cache shared by every font
+    // NOTE: FreeType has no multi-channel renderer, FONT_MSDF glyphs are always generated from the stb_truetype outline
+    if (type != FONT_MSDF) return FreeTypeFontEngine::instance().loadFontData(fileData, dataSize, fontSize, codepoints, codepointCount, type);
 #endif
 
     GlyphInfo *chars = NULL;
@@ -211,78 +782,32 @@ GlyphInfo *LoadFontData(const unsigned char *fileData, int dataSize, int fontSiz
 
             chars = (GlyphInfo *)calloc(codepointCount, sizeof(GlyphInfo));
 
-            // NOTE: Using simple packaging, one char after another
-            for (int i = 0; i < codepointCount; i++) {
-                int chw = 0, chh = 0;    // Character width and height (on generation)
-                int ch = codepoints[i];  // Character value to get info for
-                chars[i].value = ch;
-
-                //  Render a unicode codepoint to a bitmap
-                //      stbtt_GetCodepointBitmap()           -- allocates and returns a bitmap
-                //      stbtt_GetCodepointBitmapBox()        -- how big the bitmap must be
-                //      stbtt_MakeCodepointBitmap()          -- renders into bitmap you provide
-
-                // Check if a glyph is available in the font
-                // WARNING: if (index == 0), glyph not found, it could fallback to default .notdef glyph (if defined in font)
-                int index = stbtt_FindGlyphIndex(&fontInfo, ch);
-
-                if (index > 0) {
-                    switch (type) {
-                        case FONT_DEFAULT:
-                        case FONT_BITMAP:
-                            chars[i].image.data = stbtt_GetCodepointBitmap(&fontInfo, scaleFactor, scaleFactor, ch, &chw, &chh, &chars[i].offsetX, &chars[i].offsetY);
-                            break;
-                        case FONT_SDF:
-                            if (ch != 32) chars[i].image.data = stbtt_GetCodepointSDF(&fontInfo, scaleFactor, ch, FONT_SDF_CHAR_PADDING, FONT_SDF_ON_EDGE_VALUE, FONT_SDF_PIXEL_DIST_SCALE, &chw, &chh, &chars[i].offsetX, &chars[i].offsetY);
-                            break;
-                        default:
-                            break;
-                    }
-
-                    if (chars[i].image.data != NULL)  // Glyph data has been found in the font
-                    {
-                        stbtt_GetCodepointHMetrics(&fontInfo, ch, &chars[i].advanceX, NULL);
-                        chars[i].advanceX = (int)((float)chars[i].advanceX * scaleFactor);
+            // Every glyph only writes its own GlyphInfo entry, so the codepoints array is split between workers,
+            // output is the same as generating them one after another
+            int threadCount = (int)std::thread::hardware_concurrency();
+            if (threadCount > FONT_LOAD_MAX_THREADS) threadCount = FONT_LOAD_MAX_THREADS;
+            if (threadCount > codepointCount / FONT_LOAD_MIN_GLYPHS_PER_THREAD) threadCount = codepointCount / FONT_LOAD_MIN_GLYPHS_PER_THREAD;
 
-                        // Load characters images
-                        chars[i].image.width = chw;
-                        chars[i].image.height = chh;
-                        chars[i].image.mipmaps = 1;
-                        chars[i].image.format = PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
-
-                        chars[i].offsetY += (int)((float)ascent * scaleFactor);
-                    }
-
-                    // NOTE: We create an empty image for space character,
-                    // it could be further required for atlas packing
-                    if (ch == 32) {
-                        stbtt_GetCodepointHMetrics(&fontInfo, ch, &chars[i].advanceX, NULL);
-                        chars[i].advanceX = (int)((float)chars[i].advanceX * scaleFactor);
-
-                        Image imSpace = {
-                            .data = calloc(chars[i].advanceX * fontSize, 2),
-                            .width = chars[i].advanceX,
-                            .height = fontSize,
-                            .mipmaps = 1,
-                            .format = PIXELFORMAT_UNCOMPRESSED_GRAYSCALE
-                        };
-
-                        chars[i].image = imSpace;
+            if (threadCount <= 1) {
+                for (int i = 0; i < codepointCount; i++) LoadGlyphData(&fontInfo, scaleFactor, ascent, fontSize, codepoints[i], type, &chars[i]);
+            } else {
+                // Glyph cost varies a lot (space vs complex glyphs), workers grab small batches until none is left
+                std::atomic<int> nextGlyph{ 0 };
+                auto worker = [&]() {
+                    for (;;) {
+                        int first = nextGlyph.fetch_add(FONT_LOAD_GLYPHS_PER_BATCH);
+                        if (first >= codepointCount) break;
+
+                        int last = (first + FONT_LOAD_GLYPHS_PER_BATCH < codepointCount) ? first + FONT_LOAD_GLYPHS_PER_BATCH : codepointCount;
+                        for (int i = first; i < last; i++) LoadGlyphData(&fontInfo, scaleFactor, ascent, fontSize, codepoints[i], type, &chars[i]);
                     }
+                };
 
-                    if (type == FONT_BITMAP) {
-                        // Aliased bitmap (black & white) font generation, avoiding anti-aliasing
-                        // NOTE: For optimum results, bitmap font should be generated at base pixel size
-                        for (int p = 0; p < chw * chh; p++) {
-                            if (((unsigned char *)chars[i].image.data)[p] < FONT_BITMAP_ALPHA_THRESHOLD)
-                                ((unsigned char *)chars[i].image.data)[p] = 0;
-                            else
-                                ((unsigned char *)chars[i].image.data)[p] = 255;
-                        }
-                    }
-                } else {
-                    // TODO: Use some fallback glyph for codepoints not found in the font
-                }
+                std::vector<std::thread> workers;
+                workers.reserve(threadCount - 1);
+                for (int t = 1; t < threadCount; t++) workers.emplace_back(worker);
+                worker();  // Calling thread works too
+                for (std::thread &thread : workers) thread.join();
             }
         } else
             TRACELOG(LOG_WARNING, "FONT: Failed to process TTF font data");
@@ -293,6 +818,166 @@ GlyphInfo *LoadFontData(const unsigned char *fileData, int dataSize, int fontSiz
     return chars;
 }
 
+// Load kerning (GPOS or kern table) of every pair (first, second) with a non zero adjustment
+// NOTE: Fonts with only a kern table are read in one pass, GPOS needs a lookup per pair
+KerningPair *LoadFontKerning(const unsigned char *fileData, int dataSize, int fontSize, const int *firstCodepoints, int firstCount, const int *secondCodepoints, int secondCount, int *pairCount) {
+    std::vector<KerningPair> pairs;
+    *pairCount = 0;
+
+    stbtt_fontinfo fontInfo = { 0 };
+    if ((fileData == NULL) || !stbtt_InitFont(&fontInfo, (unsigned char *)fileData, 0)) return NULL;
+
+    float scaleFactor = stbtt_ScaleForPixelHeight(&fontInfo, (float)fontSize);
+
+    int tableLength = (fontInfo.gpos == 0) ? stbtt_GetKerningTableLength(&fontInfo) : 0;
+
+    if (tableLength > 0) {
+        std::vector<stbtt_kerningentry> table(tableLength);
+        tableLength = stbtt_GetKerningTable(&fontInfo, table.data(), tableLength);
+
+        // Table entries use glyph ids, map them back to the requested codepoints
+        std::unordered_multimap<int, int> firstGlyphs, secondGlyphs;
+        for (int i = 0; i < firstCount; i++) firstGlyphs.emplace(stbtt_FindGlyphIndex(&fontInfo, firstCodepoints[i]), firstCodepoints[i]);
+        for (int i = 0; i < secondCount; i++) secondGlyphs.emplace(stbtt_FindGlyphIndex(&fontInfo, secondCodepoints[i]), secondCodepoints[i]);
+
+        for (int i = 0; i < tableLength; i++) {
+            if (table[i].advance == 0) continue;
+
+            auto firstRange = firstGlyphs.equal_range(table[i].glyph1);
+            for (auto first = firstRange.first; first != firstRange.second; ++first) {
+                auto secondRange = secondGlyphs.equal_range(table[i].glyph2);
+                for (auto second = secondRange.first; second != secondRange.second; ++second) {
+                    pairs.push_back({ first->second, second->second, table[i].advance * scaleFactor });
+                }
+            }
+        }
+    } else if ((fontInfo.gpos != 0) || (fontInfo.kern != 0)) {
+        std::vector<int> secondGlyphs(secondCount);
+        for (int j = 0; j < secondCount; j++) secondGlyphs[j] = stbtt_FindGlyphIndex(&fontInfo, secondCodepoints[j]);
+
+        for (int i = 0; i < firstCount; i++) {
+            int firstGlyph = stbtt_FindGlyphIndex(&fontInfo, firstCodepoints[i]);
+            if (firstGlyph == 0) continue;
+
+            for (int j = 0; j < secondCount; j++) {
+                if (secondGlyphs[j] == 0) continue;
+
+                int advance = stbtt_GetGlyphKernAdvance(&fontInfo, firstGlyph, secondGlyphs[j]);
+                if (advance != 0) pairs.push_back({ firstCodepoints[i], secondCodepoints[j], advance * scaleFactor });
+            }
+        }
+    }
+
+    if (pairs.empty()) return NULL;
+
+    KerningPair *result = (KerningPair *)malloc(pairs.size() * sizeof(KerningPair));
+    memcpy(result, pairs.data(), pairs.size() * sizeof(KerningPair));
+    *pairCount = (int)pairs.size();
+
+    return result;
+}
+
+struct KerningSource {
+    stbtt_fontinfo fontInfo;
+    float scaleFactor;
+    bool kernTable;  // Pairs come from the kern table, otherwise they are looked up (GPOS)
+    // Kern table entries by glyph id of either side: other glyph id and advance in pixels
+    std::unordered_map<int, std::vector<std::pair<int, float>>> pairsByFirst, pairsBySecond;
+    std::unordered_multimap<int, int> glyphCodepoints;   // Glyph id -> added codepoints
+    std::vector<std::pair<int, int>> addedGlyphs;        // (codepoint, glyph id) of the added codepoints
+    std::unordered_set<int> addedCodepoints;
+};
+
+// Load kerning source, a kern table is read once here
+KerningSource *LoadKerningSource(const unsigned char *fileData, int dataSize, int fontSize) {
+    if (fileData == NULL) return NULL;
+
+    KerningSource *source = new KerningSource();
+    if (!stbtt_InitFont(&source->fontInfo, (unsigned char *)fileData, 0)) {
+        TRACELOG(LOG_WARNING, "FONT: Failed to process TTF font data for kerning");
+        delete source;
+        return NULL;
+    }
+
+    source->scaleFactor = stbtt_ScaleForPixelHeight(&source->fontInfo, (float)fontSize);
+
+    int tableLength = (source->fontInfo.gpos == 0) ? stbtt_GetKerningTableLength(&source->fontInfo) : 0;
+    source->kernTable = (tableLength > 0);
+
+    if (source->kernTable) {
+        std::vector<stbtt_kerningentry> table(tableLength);
+        tableLength = stbtt_GetKerningTable(&source->fontInfo, table.data(), tableLength);
+
+        for (int i = 0; i < tableLength; i++) {
+            if (table[i].advance == 0) continue;
+
+            float advance = table[i].advance * source->scaleFactor;
+            source->pairsByFirst[table[i].glyph1].emplace_back(table[i].glyph2, advance);
+            source->pairsBySecond[table[i].glyph2].emplace_back(table[i].glyph1, advance);
+        }
+    }
+
+    return source;
+}
+
+// Add codepoint to the source, returns its pairs with itself and every codepoint added before, both ways
+// NOTE: Kern table pairs are found through the new glyph only, GPOS needs a lookup per added codepoint
+KerningPair *AddKerningCodepoint(KerningSource *source, int codepoint, int *pairCount) {
+    *pairCount = 0;
+    if ((source == NULL) || !source->addedCodepoints.insert(codepoint).second) return NULL;
+
+    int glyph = stbtt_FindGlyphIndex(&source->fontInfo, codepoint);
+    if (glyph == 0) return NULL;
+
+    source->glyphCodepoints.emplace(glyph, codepoint);
+    source->addedGlyphs.emplace_back(codepoint, glyph);
+
+    std::vector<KerningPair> pairs;
+
+    if (source->kernTable) {
+        auto firstIt = source->pairsByFirst.find(glyph);
+        if (firstIt != source->pairsByFirst.end()) {
+            for (const auto &entry : firstIt->second) {
+                auto range = source->glyphCodepoints.equal_range(entry.first);
+                for (auto second = range.first; second != range.second; ++second) pairs.push_back({ codepoint, second->second, entry.second });
+            }
+        }
+
+        auto secondIt = source->pairsBySecond.find(glyph);
+        if (secondIt != source->pairsBySecond.end()) {
+            for (const auto &entry : secondIt->second) {
+                auto range = source->glyphCodepoints.equal_range(entry.first);
+                for (auto first = range.first; first != range.second; ++first) {
+                    // (codepoint, codepoint) was added by the first pass
+                    if (first->second != codepoint) pairs.push_back({ first->second, codepoint, entry.second });
+                }
+            }
+        }
+    } else if ((source->fontInfo.gpos != 0) || (source->fontInfo.kern != 0)) {
+        for (const auto &added : source->addedGlyphs) {
+            int advance = stbtt_GetGlyphKernAdvance(&source->fontInfo, glyph, added.second);
+            if (advance != 0) pairs.push_back({ codepoint, added.first, advance * source->scaleFactor });
+
+            if (added.first == codepoint) continue;
+
+            advance = stbtt_GetGlyphKernAdvance(&source->fontInfo, added.second, glyph);
+            if (advance != 0) pairs.push_back({ added.first, codepoint, advance * source->scaleFactor });
+        }
+    }
+
+    if (pairs.empty()) return NULL;
+
+    KerningPair *result = (KerningPair *)malloc(pairs.size() * sizeof(KerningPair));
+    memcpy(result, pairs.data(), pairs.size() * sizeof(KerningPair));
+    *pairCount = (int)pairs.size();
+
+    return result;
+}
+
+void UnloadKerningSource(KerningSource *source) {
+    delete source;
+}
+
 // Generate image font atlas using chars info
 // NOTE: Packing method: 0-Default, 1-Skyline
 Image GenImageFontAtlas(const GlyphInfo *glyphs, Rectangle **glyphRecs, int glyphCount, int fontSize, int padding, int packMethod) {
@@ -334,8 +1019,14 @@ Image GenImageFontAtlas(const GlyphInfo *glyphs, Rectangle **glyphRecs, int glyp
         atlas.height = imageSize;  // Atlas bitmap height
     }
 
-    atlas.data = (unsigned char *)calloc(1, atlas.width * atlas.height);  // Create a bitmap to store characters (8 bpp)
-    atlas.format = PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+    // MSDF glyphs keep their three channels, every other font type is 8 bpp
+    int channels = 1;
+    for (int i = 0; i < glyphCount; i++) {
+        if (glyphs[i].image.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8) channels = 3;
+    }
+
+    atlas.data = (unsigned char *)calloc(channels, atlas.width * atlas.height);  // Create a bitmap to store characters
+    atlas.format = (channels == 3) ? PIXELFORMAT_UNCOMPRESSED_R8G8B8 : PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
     atlas.mipmaps = 1;
 
     // DEBUG: We can see padding in the generated image setting a gray background...
@@ -372,9 +1063,8 @@ Image GenImageFontAtlas(const GlyphInfo *glyphs, Rectangle **glyphRecs, int glyp
 
             // Copy pixel data from glyph image to atlas
             for (int y = 0; y < glyphs[i].image.height; y++) {
-                for (int x = 0; x < glyphs[i].image.width; x++) {
-                    ((unsigned char *)atlas.data)[(offsetY + y) * atlas.width + (offsetX + x)] = ((unsigned char *)glyphs[i].image.data)[y * glyphs[i].image.width + x];
-                }
+                memcpy((unsigned char *)atlas.data + ((offsetY + y) * atlas.width + offsetX) * channels,
+                       (unsigned char *)glyphs[i].image.data + y * glyphs[i].image.width * channels, glyphs[i].image.width * channels);
             }
 
             // Fill chars rectangles in atlas info
@@ -414,9 +1104,8 @@ Image GenImageFontAtlas(const GlyphInfo *glyphs, Rectangle **glyphRecs, int glyp
             if (rects[i].was_packed) {
                 // Copy pixel data from fc.data to atlas
                 for (int y = 0; y < glyphs[i].image.height; y++) {
-                    for (int x = 0; x < glyphs[i].image.width; x++) {
-                        ((unsigned char *)atlas.data)[(rects[i].y + padding + y) * atlas.width + (rects[i].x + padding + x)] = ((unsigned char *)glyphs[i].image.data)[y * glyphs[i].image.width + x];
-                    }
+                    memcpy((unsigned char *)atlas.data + ((rects[i].y + padding + y) * atlas.width + rects[i].x + padding) * channels,
+                           (unsigned char *)glyphs[i].image.data + y * glyphs[i].image.width * channels, glyphs[i].image.width * channels);
                 }
             } else
                 TRACELOG(LOG_WARNING, "FONT: Failed to package character (%i)", i);
@@ -439,21 +1128,129 @@ Image GenImageFontAtlas(const GlyphInfo *glyphs, Rectangle **glyphRecs, int glyp
     }
 #endif
 
-    // Convert image data from GRAYSCALE to GRAY_ALPHA
-    unsigned char *dataGrayAlpha = (unsigned char *)malloc(atlas.width * atlas.height * sizeof(unsigned char) * 2);  // Two channels
+    // NOTE: Atlas is kept GRAYSCALE instead of expanding it to GRAY_ALPHA with a constant gray channel,
+    // the texture swizzles the single channel to alpha when it is loaded
 
-    for (int i = 0, k = 0; i < atlas.width * atlas.height; i++, k += 2) {
-        dataGrayAlpha[k] = 255;
-        dataGrayAlpha[k + 1] = ((unsigned char *)atlas.data)[i];
+    *glyphRecs = recs;
+
+    return atlas;
+}
+
+// Encode a 4x4 block of 8-bit values to 8 bytes of RGTC1 (BC4): two endpoints and a 3 bit index per texel
+// NOTE: Both encodings are tried, 8 interpolated levels or 6 levels plus exact 0 and 255 for blocks touching
+// the saturated outside/inside areas of an SDF, the one with lowest squared error is kept
+static void EncodeBlockRGTC1(const unsigned char *texels, unsigned char *block) {
+    int minValue = 255, maxValue = 0;        // Range of the block
+    int minInner = 255, maxInner = 0;        // Range without the 0 and 255 values
+    for (int i = 0; i < 16; i++) {
+        minValue = (texels[i] < minValue) ? texels[i] : minValue;
+        maxValue = (texels[i] > maxValue) ? texels[i] : maxValue;
+
+        if ((texels[i] == 0) || (texels[i] == 255)) continue;
+        minInner = (texels[i] < minInner) ? texels[i] : minInner;
+        maxInner = (texels[i] > maxInner) ? texels[i] : maxInner;
     }
 
-    free(atlas.data);
-    atlas.data = dataGrayAlpha;
-    atlas.format = PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA;
+    unsigned long long bestIndices = 0;
+    int bestError = -1;
+    int bestRed0 = maxValue, bestRed1 = minValue;
+
+    for (int mode = 0; mode < 2; mode++) {
+        int red0 = 0, red1 = 0;
+        int palette[8] = { 0 };
+
+        if (mode == 0) {
+            // red0 > red1: 6 values interpolated between both endpoints
+            if (maxValue == minValue) break;  // Flat block, the default endpoints with index 0 are exact
+
+            red0 = maxValue;
+            red1 = minValue;
+            palette[0] = red0;
+            palette[1] = red1;
+            for (int i = 2; i < 8; i++) palette[i] = ((8 - i) * red0 + (i - 1) * red1 + 3) / 7;
+        } else {
+            // red0 <= red1: 4 values interpolated between both endpoints, plus 0 and 255
+            if ((minValue != 0) && (maxValue != 255)) break;
+
+            red0 = (minInner > maxInner) ? 0 : minInner;
+            red1 = (minInner > maxInner) ? 255 : maxInner;
+            palette[0] = red0;
+            palette[1] = red1;
+            for (int i = 2; i < 6; i++) palette[i] = ((6 - i) * red0 + (i - 1) * red1 + 2) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
 
-    *glyphRecs = recs;
+        unsigned long long indices = 0;
+        int error = 0;
 
-    return atlas;
+        for (int i = 0; i < 16; i++) {
+            int bestIndex = 0;
+            int bestDistance = 256 * 256;
+
+            for (int j = 0; j < 8; j++) {
+                int distance = (texels[i] - palette[j]) * (texels[i] - palette[j]);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    bestIndex = j;
+                }
+            }
+
+            indices |= (unsigned long long)bestIndex << (3 * i);
+            error += bestDistance;
+        }
+
+        if ((bestError < 0) || (error < bestError)) {
+            bestError = error;
+            bestIndices = indices;
+            bestRed0 = red0;
+            bestRed1 = red1;
+        }
+    }
+
+    block[0] = (unsigned char)bestRed0;
+    block[1] = (unsigned char)bestRed1;
+    for (int i = 0; i < 6; i++) block[2 + i] = (unsigned char)(bestIndices >> (8 * i));
+}
+
+// Encode a GRAYSCALE image to PIXELFORMAT_COMPRESSED_RGTC1_R (BC4), 8 bytes per 4x4 block
+// NOTE: Blocks crossing the right or bottom border repeat the last column/row
+bool ImageCompressRGTC1(Image *image) {
+    if ((image == NULL) || (image->data == NULL) || (image->width == 0) || (image->height == 0)) return false;
+
+    if (image->format != PIXELFORMAT_UNCOMPRESSED_GRAYSCALE) {
+        TRACELOG(LOG_WARNING, "IMAGE: RGTC1 compression requires a GRAYSCALE image (%s)", rlGetPixelFormatName(image->format));
+        return false;
+    }
+
+    const unsigned char *pixels = (const unsigned char *)image->data;
+    int blocksX = (image->width + 3) / 4;
+    int blocksY = (image->height + 3) / 4;
+    unsigned char *compressed = (unsigned char *)malloc(rlGetPixelDataSize(image->width, image->height, PIXELFORMAT_COMPRESSED_RGTC1_R));
+
+    for (int by = 0; by < blocksY; by++) {
+        for (int bx = 0; bx < blocksX; bx++) {
+            unsigned char texels[16];
+
+            for (int y = 0; y < 4; y++) {
+                int py = (by * 4 + y < image->height) ? by * 4 + y : image->height - 1;
+
+                for (int x = 0; x < 4; x++) {
+                    int px = (bx * 4 + x < image->width) ? bx * 4 + x : image->width - 1;
+                    texels[y * 4 + x] = pixels[py * image->width + px];
+                }
+            }
+
+            EncodeBlockRGTC1(texels, compressed + (by * blocksX + bx) * 8);
+        }
+    }
+
+    free(image->data);
+    image->data = compressed;
+    image->format = PIXELFORMAT_COMPRESSED_RGTC1_R;
+    image->mipmaps = 1;
+
+    return true;
 }
 
 // Formatting of text with variables to 'embed'
@@ -530,6 +1327,7 @@ int rlGetPixelDataSize(int width, int height, int format) {
             break;
         case RL_PIXELFORMAT_COMPRESSED_DXT1_RGB:
         case RL_PIXELFORMAT_COMPRESSED_DXT1_RGBA:
+        case RL_PIXELFORMAT_COMPRESSED_RGTC1_R:
         case RL_PIXELFORMAT_COMPRESSED_ETC1_RGB:
         case RL_PIXELFORMAT_COMPRESSED_ETC2_RGB:
         case RL_PIXELFORMAT_COMPRESSED_PVRT_RGB:
@@ -560,6 +1358,9 @@ int rlGetPixelDataSize(int width, int height, int format) {
             dataSize = 16;
     }
 
+    // RGTC1 stores partial blocks on the borders as whole blocks
+    if (format == RL_PIXELFORMAT_COMPRESSED_RGTC1_R) dataSize = ((width + 3) / 4) * ((height + 3) / 4) * 8;
+
     return dataSize;
 }
 
@@ -635,6 +1436,9 @@ void rlGetGlTextureFormats(int format, unsigned int *glInternalFormat, unsigned
             *glFormat = GL_RGBA;
             *glType = GL_HALF_FLOAT;
             break;
+        case RL_PIXELFORMAT_COMPRESSED_RGTC1_R:
+            *glInternalFormat = GL_COMPRESSED_RED_RGTC1;  // Core since OpenGL 3.0
+            break;
         default:
             TRACELOG(RL_LOG_WARNING, "TEXTURE: Current format not supported (%i)", format);
             break;
@@ -716,6 +1520,9 @@ const char *rlGetPixelFormatName(unsigned int format) {
         case RL_PIXELFORMAT_COMPRESSED_ASTC_8x8_RGBA:
             return "ASTC_8x8_RGBA";
             break;  // 2 bpp
+        case RL_PIXELFORMAT_COMPRESSED_RGTC1_R:
+            return "RGTC1_R";
+            break;  // 4 bpp
         default:
             return "UNKNOWN";
             break;
@@ -724,7 +1531,7 @@ const char *rlGetPixelFormatName(unsigned int format) {
 
 // Set texture parameters (wrap mode/filter mode)
 void rlTextureParameters(unsigned int id, int param, int value) {
-    glBindTexture(GL_TEXTURE_2D, id);
+    GLState::instance().bindTexture(GL_TEXTURE_2D, id);
 
     switch (param) {
         case RL_TEXTURE_WRAP_S:
@@ -741,7 +1548,7 @@ void rlTextureParameters(unsigned int id, int param, int value) {
             break;
     }
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::instance().bindTexture(GL_TEXTURE_2D, 0);
 }
 
 // Set texture scaling filter mode
@@ -842,7 +1649,7 @@ int GetCodepointNext(const char *text, int *codepointSize) {
 
 // Get index position for a unicode character on font
 // NOTE: If codepoint is not found in the font it fallbacks to '?'
-int GetGlyphIndex(Font font, int codepoint) {
+int GetGlyphIndex(const Font &font, int codepoint) {
     int index = 0;
 
     int fallbackIndex = 0;  // Get index of fallback glyph '?'
@@ -869,11 +1676,8 @@ int GetGlyphIndex(Font font, int codepoint) {
 unsigned int TextLength(const char *text) {
     unsigned int length = 0;
 
-    if (text != NULL) {
-        // NOTE: Alternative: use strlen(text)
-
-        while (*text++) length++;
-    }
+    // NOTE: strlen() scans a word (or a vector register) at a time instead of byte by byte
+    if (text != NULL) length = (unsigned int)strlen(text);
 
     return length;
 }
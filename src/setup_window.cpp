@@ -190,8 +190,10 @@ GLFWwindow *InitWindow(int windowWidth, int windowHeight, const char *title) {
     // with backward compatibility to older OpenGL versions.
     // For example, if using OpenGL 1.1, driver can provide a 4.3 backwards compatible context.
 
-    // helpful for debugging
+    // Debug context reports errors through the debug output, see GLDebug.hpp
+#ifdef GRAPHICS_GL_DEBUG
     glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+#endif
 
     // GL 3.0 + GLSL 130
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
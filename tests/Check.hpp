@@ -0,0 +1,32 @@
+#ifndef GRAPHICS_TESTS_CHECK_HPP
+#define GRAPHICS_TESTS_CHECK_HPP
+
+#include <iostream>
+
+// Minimal checks for the ctest executables: a failed check is reported with its line and counted,
+// main() returns CheckFailures() so ctest marks the test as failed
+inline int& CheckFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                    \
+    do {                                                                                    \
+        if (!(condition)) {                                                                 \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed\n"; \
+            CheckFailures()++;                                                              \
+        }                                                                                   \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                                                   \
+    do {                                                                                                             \
+        const auto& checkActual = (actual);                                                                          \
+        const auto& checkExpected = (expected);                                                                      \
+        if (!(checkActual == checkExpected)) {                                                                       \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK_EQ(" #actual ", " #expected ") failed: " << checkActual \
+                      << " != " << checkExpected << "\n";                                                            \
+            CheckFailures()++;                                                                                       \
+        }                                                                                                            \
+    } while (0)
+
+#endif
@@ -0,0 +1,110 @@
+#include <vector>
+
+//
+#include "Check.hpp"
+#include "Label/GlyphIndexTable.hpp"
+
+namespace {
+
+// Font with only glyph values set, the table reads nothing else
+Font MakeFont(std::vector<GlyphInfo>& glyphs, const std::vector<int>& codepoints) {
+    glyphs.assign(codepoints.size(), GlyphInfo{ 0 });
+    for (size_t i = 0; i < codepoints.size(); i++) glyphs[i].value = codepoints[i];
+
+    Font font = { 0 };
+    font.glyphCount = (int)glyphs.size();
+    font.glyphs = glyphs.data();
+
+    return font;
+}
+
+// Index of the first glyph with codepoint, fallback when missing (GetGlyphIndex() without the table)
+int LinearGlyphIndex(const Font& font, int codepoint, int fallback) {
+    for (int i = 0; i < font.glyphCount; i++) {
+        if (font.glyphs[i].value == codepoint) return i;
+    }
+
+    return fallback;
+}
+
+void TestLookupAboveDirectRange() {
+    std::vector<GlyphInfo> glyphs;
+    std::vector<int> codepoints = { 'A', '?', 0x7FF, GLYPH_INDEX_DIRECT_RANGE, 0x4E2D, 0xFFFD, 0x10000, 0x1F600, 0x10FFFF, 'A' };
+    // Enough sparse codepoints to grow the hash table several times
+    for (int i = 0; i < 200; i++) codepoints.push_back(0x4E00 + i * 37);
+
+    Font font = MakeFont(glyphs, codepoints);
+    GlyphIndexTable table;
+    table.build(font);
+
+    CHECK_EQ(table.fallbackIndex, 1);
+    for (int codepoint : codepoints) CHECK_EQ(table.find(codepoint), LinearGlyphIndex(font, codepoint, -1));
+
+    // Duplicated codepoints keep the first glyph, same as the linear scan
+    CHECK_EQ(table.find('A'), 0);
+    CHECK_EQ(table.find(GLYPH_INDEX_DIRECT_RANGE), 3);
+    CHECK_EQ(table.find(0x1F600), 7);
+}
+
+void TestMisses() {
+    std::vector<GlyphInfo> glyphs;
+    Font font = MakeFont(glyphs, { 'a', '?', 0x4E2D, 0x1F600 });
+    GlyphIndexTable table;
+    table.build(font);
+
+    // Below the direct range, past the end of the direct array, above the BMP and invalid codepoints
+    const int misses[] = { 'b', 0x7FF, GLYPH_INDEX_DIRECT_RANGE, 0x4E2E, 0x1F601, 0x10FFFF, 0x110000, -1, -5 };
+    for (int codepoint : misses) {
+        CHECK_EQ(table.find(codepoint), -1);
+        CHECK_EQ(table.get(codepoint), LinearGlyphIndex(font, '?', 0));
+    }
+
+    // Without '?' the first glyph is the fallback, same as GetGlyphIndex()
+    Font noFallback = MakeFont(glyphs, { 'x', 0x4E2D });
+    table.build(noFallback);
+    CHECK_EQ(table.fallbackIndex, 0);
+    CHECK_EQ(table.get(0x1F600), 0);
+    CHECK_EQ(table.get(0x4E2D), 1);
+
+    // An empty table misses everything
+    GlyphIndexTable empty;
+    CHECK_EQ(empty.find('a'), -1);
+    CHECK_EQ(empty.find(0x1F600), -1);
+}
+
+void TestSetAndErase() {
+    GlyphIndexTable table;
+
+    for (int i = 0; i < 1000; i++) table.set(0x20000 + i * 13, i);
+    for (int i = 0; i < 1000; i += 2) table.erase(0x20000 + i * 13);
+
+    for (int i = 0; i < 1000; i++) CHECK_EQ(table.find(0x20000 + i * 13), (i % 2 == 0) ? -1 : i);
+
+    // Erased slots (tombstones) are reused, probing still reaches the entries behind them
+    for (int i = 0; i < 1000; i += 2) table.set(0x20000 + i * 13, i + 5000);
+    for (int i = 0; i < 1000; i++) CHECK_EQ(table.find(0x20000 + i * 13), (i % 2 == 0) ? i + 5000 : i);
+
+    // Overwriting keeps a single entry per codepoint
+    table.set(0x1F600, 1);
+    table.set(0x1F600, 2);
+    CHECK_EQ(table.find(0x1F600), 2);
+    table.erase(0x1F600);
+    CHECK_EQ(table.find(0x1F600), -1);
+
+    table.set('z', 7);
+    CHECK_EQ(table.find('z'), 7);
+    table.erase('z');
+    CHECK_EQ(table.find('z'), -1);
+    table.erase(0x7FE);  // Past the end of the direct array, nothing to erase
+    CHECK_EQ(table.find(0x7FE), -1);
+}
+
+}  // namespace
+
+int main() {
+    TestLookupAboveDirectRange();
+    TestMisses();
+    TestSetAndErase();
+
+    return CheckFailures();
+}
@@ -0,0 +1,101 @@
+#include <math.h>
+#include <stdlib.h>
+
+//
+#include "Check.hpp"
+#include "Label/helpers.hpp"
+#include "stb_rect_pack.h"
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "stb_truetype.h"
+
+// FONT_SDF glyphs of LoadFontData() (distance transform of a FONT_SDF_SUPERSAMPLE bitmap) against
+// stbtt_GetCodepointSDF(), the exact distance to the outline they replace
+
+namespace {
+
+// Distance of one pixel in SDF levels
+const float PIXEL_LEVELS = FONT_SDF_PIXEL_DIST_SCALE;
+
+void TestFont(const char* fileName, int fontSize) {
+    int dataSize = 0;
+    unsigned char* fileData = LoadFileData(fileName, &dataSize);
+    CHECK(fileData != NULL);
+    if (fileData == NULL) return;
+
+    stbtt_fontinfo fontInfo;
+    CHECK(stbtt_InitFont(&fontInfo, fileData, stbtt_GetFontOffsetForIndex(fileData, 0)));
+    float scale = stbtt_ScaleForPixelHeight(&fontInfo, (float)fontSize);
+    int ascent = 0, descent = 0, lineGap = 0;
+    stbtt_GetFontVMetrics(&fontInfo, &ascent, &descent, &lineGap);
+
+    int codepoints[] = { 'A', 'B', 'O', 'W', 'a', 'e', 'g', 'i', 'o', 's', '8', '@', '&', '%', '.' };
+    const int codepointCount = sizeof(codepoints) / sizeof(codepoints[0]);
+
+    GlyphInfo* glyphs = LoadFontData(fileData, dataSize, fontSize, codepoints, codepointCount, FONT_SDF);
+    CHECK(glyphs != NULL);
+    if (glyphs == NULL) return;
+
+    for (int i = 0; i < codepointCount; i++) {
+        const GlyphInfo& glyph = glyphs[i];
+        int width = 0, height = 0, offsetX = 0, offsetY = 0;
+        unsigned char* expected = stbtt_GetCodepointSDF(&fontInfo, scale, codepoints[i], FONT_SDF_CHAR_PADDING, FONT_SDF_ON_EDGE_VALUE,
+                                                        FONT_SDF_PIXEL_DIST_SCALE, &width, &height, &offsetX, &offsetY);
+        CHECK(expected != NULL);
+        CHECK(glyph.image.data != NULL);
+        if ((expected == NULL) || (glyph.image.data == NULL)) continue;
+
+        // Same bitmap box and placement, so both generators can replace each other in an atlas
+        CHECK_EQ(glyph.value, codepoints[i]);
+        CHECK_EQ(glyph.image.format, (int)PIXELFORMAT_UNCOMPRESSED_GRAYSCALE);
+        CHECK_EQ(glyph.image.width, width);
+        CHECK_EQ(glyph.image.height, height);
+        CHECK_EQ(glyph.offsetX, offsetX);
+        CHECK_EQ(glyph.offsetY, offsetY + (int)((float)ascent * scale));
+
+        if ((glyph.image.width != width) || (glyph.image.height != height)) {
+            free(expected);
+            continue;
+        }
+
+        const unsigned char* pixels = (const unsigned char*)glyph.image.data;
+        int wrongSide = 0;
+        float maxError = 0.0f, totalError = 0.0f;
+
+        for (int p = 0; p < width * height; p++) {
+            float value = (float)pixels[p];
+            float reference = (float)expected[p];
+
+            // Inside the outline is at or above FONT_SDF_ON_EDGE_VALUE. Pixels within a quarter pixel of
+            // the outline may land on either side, the supersampled bitmap moves the edge slightly
+            bool inside = pixels[p] >= FONT_SDF_ON_EDGE_VALUE;
+            bool referenceInside = expected[p] >= FONT_SDF_ON_EDGE_VALUE;
+            if ((inside != referenceInside) && (fabsf(reference - FONT_SDF_ON_EDGE_VALUE) > 0.25f * PIXEL_LEVELS)) wrongSide++;
+
+            // Saturated values of both generators are not compared, the distance beyond them is unknown
+            if (((value == 0.0f) || (value == 255.0f)) && (value == reference)) continue;
+            float error = fabsf(value - reference);
+            maxError = (error > maxError) ? error : maxError;
+            totalError += error;
+        }
+
+        CHECK_EQ(wrongSide, 0);
+        CHECK(maxError <= 0.5f * PIXEL_LEVELS);
+        CHECK(totalError / (float)(width * height) <= 0.05f * PIXEL_LEVELS);
+
+        free(expected);
+    }
+
+    for (int i = 0; i < codepointCount; i++) free(glyphs[i].image.data);
+    free(glyphs);
+    free(fileData);
+}
+
+}  // namespace
+
+int main() {
+    TestFont(GRAPHICS_TEST_ASSETS "/fonts/RobotoRegular.ttf", 32);
+    TestFont(GRAPHICS_TEST_ASSETS "/fonts/DroidSerif-Regular.ttf", 64);
+
+    return CheckFailures();
+}
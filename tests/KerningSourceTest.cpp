@@ -0,0 +1,251 @@
+#include <math.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+//
+#include "Check.hpp"
+#include "Label/helpers.hpp"
+
+// AddKerningCodepoint() pairs, accumulated one codepoint at a time, against LoadFontKerning() on
+// the whole codepoint set. The font files of assets/ only have GPOS kerning, the kern table path
+// runs on a minimal TrueType font built here
+
+namespace {
+
+using PairMap = std::map<std::pair<int, int>, float>;
+
+void PutU16(std::vector<unsigned char>& data, int value) {
+    data.push_back((unsigned char)(value >> 8));
+    data.push_back((unsigned char)value);
+}
+
+void PutU32(std::vector<unsigned char>& data, unsigned int value) {
+    PutU16(data, (int)(value >> 16));
+    PutU16(data, (int)(value & 0xffff));
+}
+
+struct KernEntry {
+    int first, second, advance;  // Glyph ids, advance in font units
+};
+
+// TrueType font with empty outlines: 'A'-'Z' are glyphs 1-26, 'a'-'z' 27-52, U+4E2D glyph 53 and
+// Greek capital alpha shares glyph 1 with 'A'. Kerning is a format 0 kern table
+// NOTE: Units per em 1000, ascender 800, descender -200
+std::vector<unsigned char> BuildKernFont(std::vector<KernEntry> kerning) {
+    const int glyphCount = 54;
+    std::vector<std::pair<std::string, std::vector<unsigned char>>> tables;
+
+    // cmap: one format 12 subtable for platform 3 (Windows), encoding 10 (UCS-4)
+    std::vector<unsigned char> cmap;
+    const unsigned int groups[][3] = { { 'A', 'Z', 1 }, { 'a', 'z', 27 }, { 0x391, 0x391, 1 }, { 0x4E2D, 0x4E2D, 53 } };
+    const int groupCount = sizeof(groups) / sizeof(groups[0]);
+    PutU16(cmap, 0);
+    PutU16(cmap, 1);
+    PutU16(cmap, 3);
+    PutU16(cmap, 10);
+    PutU32(cmap, 12);
+    PutU16(cmap, 12);
+    PutU16(cmap, 0);
+    PutU32(cmap, 16 + 12 * groupCount);
+    PutU32(cmap, 0);
+    PutU32(cmap, groupCount);
+    for (const auto& group : groups) {
+        PutU32(cmap, group[0]);
+        PutU32(cmap, group[1]);
+        PutU32(cmap, group[2]);
+    }
+    tables.emplace_back("cmap", cmap);
+
+    std::vector<unsigned char> glyf(4, 0);
+    tables.emplace_back("glyf", glyf);
+
+    std::vector<unsigned char> head(54, 0);
+    head[18] = 1000 >> 8;  // unitsPerEm
+    head[19] = 1000 & 0xff;
+    tables.emplace_back("head", head);  // indexToLocFormat 0: short offsets
+
+    std::vector<unsigned char> hhea;
+    PutU32(hhea, 0x00010000);
+    PutU16(hhea, 800);
+    PutU16(hhea, -200 & 0xffff);
+    hhea.resize(34, 0);
+    PutU16(hhea, glyphCount);  // numberOfHMetrics
+    tables.emplace_back("hhea", hhea);
+
+    std::vector<unsigned char> hmtx;
+    for (int i = 0; i < glyphCount; i++) {
+        PutU16(hmtx, 500);
+        PutU16(hmtx, 0);
+    }
+    tables.emplace_back("hmtx", hmtx);
+
+    // Pairs are binary searched, sorted by first then second glyph
+    std::sort(kerning.begin(), kerning.end(), [](const KernEntry& a, const KernEntry& b) {
+        return (a.first != b.first) ? (a.first < b.first) : (a.second < b.second);
+    });
+    std::vector<unsigned char> kern;
+    PutU16(kern, 0);
+    PutU16(kern, 1);
+    PutU16(kern, 0);
+    PutU16(kern, 14 + 6 * (int)kerning.size());
+    PutU16(kern, 1);  // Coverage: horizontal, format 0
+    PutU16(kern, (int)kerning.size());
+    PutU16(kern, 0);
+    PutU16(kern, 0);
+    PutU16(kern, 0);
+    for (const KernEntry& entry : kerning) {
+        PutU16(kern, entry.first);
+        PutU16(kern, entry.second);
+        PutU16(kern, entry.advance & 0xffff);
+    }
+    tables.emplace_back("kern", kern);
+
+    tables.emplace_back("loca", std::vector<unsigned char>(2 * (glyphCount + 1), 0));
+
+    std::vector<unsigned char> maxp;
+    PutU32(maxp, 0x00005000);
+    PutU16(maxp, glyphCount);
+    tables.emplace_back("maxp", maxp);
+
+    std::vector<unsigned char> font;
+    PutU32(font, 0x00010000);
+    PutU16(font, (int)tables.size());
+    PutU16(font, 0);
+    PutU16(font, 0);
+    PutU16(font, 0);
+
+    unsigned int offset = 12 + 16 * (unsigned int)tables.size();
+    for (const auto& table : tables) {
+        font.insert(font.end(), table.first.begin(), table.first.end());
+        PutU32(font, 0);
+        PutU32(font, offset);
+        PutU32(font, (unsigned int)table.second.size());
+        offset += ((unsigned int)table.second.size() + 3) & ~3u;
+    }
+    for (const auto& table : tables) {
+        font.insert(font.end(), table.second.begin(), table.second.end());
+        font.resize((font.size() + 3) & ~(size_t)3, 0);
+    }
+
+    return font;
+}
+
+PairMap ToMap(const KerningPair* pairs, int count) {
+    PairMap map;
+    for (int i = 0; i < count; i++) {
+        // Every pair is returned once
+        CHECK(map.find({ pairs[i].first, pairs[i].second }) == map.end());
+        map[{ pairs[i].first, pairs[i].second }] = pairs[i].advance;
+    }
+
+    return map;
+}
+
+// Adds the codepoints one by one, checks the union of the new pairs is the full kerning of the set
+PairMap CheckSource(const unsigned char* fileData, int dataSize, int fontSize, const std::vector<int>& codepoints) {
+    int pairCount = 0;
+    KerningPair* pairs = LoadFontKerning(fileData, dataSize, fontSize, codepoints.data(), (int)codepoints.size(), codepoints.data(), (int)codepoints.size(), &pairCount);
+    PairMap expected = ToMap(pairs, pairCount);
+    free(pairs);
+
+    KerningSource* source = LoadKerningSource(fileData, dataSize, fontSize);
+    CHECK(source != NULL);
+    if (source == NULL) return expected;
+
+    PairMap added;
+    for (int codepoint : codepoints) {
+        pairs = AddKerningCodepoint(source, codepoint, &pairCount);
+        CHECK((pairs != NULL) == (pairCount > 0));
+
+        for (const auto& pair : ToMap(pairs, pairCount)) {
+            // Pairs are only returned once the second codepoint has been added, and never twice
+            CHECK((pair.first.first == codepoint) || (pair.first.second == codepoint));
+            CHECK(added.find(pair.first) == added.end());
+            added.insert(pair);
+        }
+        free(pairs);
+
+        // Adding a codepoint again returns nothing
+        pairs = AddKerningCodepoint(source, codepoint, &pairCount);
+        CHECK(pairs == NULL);
+        CHECK_EQ(pairCount, 0);
+    }
+
+    CHECK(added == expected);
+    UnloadKerningSource(source);
+
+    return expected;
+}
+
+void TestKernTable() {
+    std::vector<KernEntry> kerning = {
+        { 1, 22, -80 },   // A V
+        { 22, 1, -80 },   // V A
+        { 1, 23, -60 },   // A W
+        { 20, 41, -100 }, // T o
+        { 1, 1, 10 },     // A A
+        { 41, 53, 20 },   // o U+4E2D
+        { 2, 2, 0 },      // B B, not kerned
+        { 25, 27, -40 },  // Y a
+    };
+    std::vector<unsigned char> font = BuildKernFont(kerning);
+    const int fontSize = 20;  // 50 font units per pixel
+    auto Near = [](float advance, float fontUnits) { return fabsf(advance - fontUnits / 50.0f) < 1e-5f; };
+
+    std::vector<int> codepoints = { 'o', 'A', 'B', 0x4E2D, 'T', 'V', 0x391, 'W', 0x10000, 'a' };
+    PairMap pairs = CheckSource(font.data(), (int)font.size(), fontSize, codepoints);
+
+    CHECK_EQ(pairs.size(), (size_t)12);
+    CHECK(Near(pairs[{ 'A', 'V' }], -80.0f));
+    CHECK(Near(pairs[{ 'T', 'o' }], -100.0f));
+    CHECK(Near(pairs[{ 'A', 'A' }], 10.0f));
+    CHECK(Near(pairs[{ 'o', 0x4E2D }], 20.0f));
+    // Greek alpha is the glyph of 'A', it has the kerning of 'A'
+    CHECK(Near(pairs[{ 0x391, 'V' }], -80.0f));
+    CHECK(Near(pairs[{ 'A', 0x391 }], 10.0f));
+    CHECK(Near(pairs[{ 0x391, 0x391 }], 10.0f));
+    CHECK(pairs.find({ 'B', 'B' }) == pairs.end());
+    CHECK(pairs.find({ 'Y', 'a' }) == pairs.end());
+
+    // Added in the other order, the same pairs are found
+    std::vector<int> reversed(codepoints.rbegin(), codepoints.rend());
+    CHECK(CheckSource(font.data(), (int)font.size(), fontSize, reversed) == pairs);
+}
+
+void TestGpos() {
+    int dataSize = 0;
+    unsigned char* fileData = LoadFileData(GRAPHICS_TEST_ASSETS "/fonts/RobotoRegular.ttf", &dataSize);
+    CHECK(fileData != NULL);
+    if (fileData == NULL) return;
+
+    std::vector<int> codepoints;
+    for (const char* c = "AVTWYLPFoaer.,y7"; *c != '\0'; c++) codepoints.push_back(*c);
+
+    PairMap pairs = CheckSource(fileData, dataSize, 32, codepoints);
+    CHECK(!pairs.empty());
+    for (const auto& pair : pairs) CHECK(pair.second != 0.0f);
+
+    free(fileData);
+}
+
+void TestInvalidSource() {
+    int pairCount = 7;
+    CHECK(AddKerningCodepoint(NULL, 'A', &pairCount) == NULL);
+    CHECK_EQ(pairCount, 0);
+    CHECK(LoadKerningSource(NULL, 0, 20) == NULL);
+}
+
+}  // namespace
+
+int main() {
+    TestKernTable();
+    TestGpos();
+    TestInvalidSource();
+
+    return CheckFailures();
+}
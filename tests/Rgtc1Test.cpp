@@ -0,0 +1,181 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+//
+#include "Check.hpp"
+#include "Label/helpers.hpp"
+
+// ImageCompressRGTC1() round trip, blocks are decoded the way the GPU does (BC4 unorm palette)
+
+namespace {
+
+std::vector<float> DecodeRGTC1(const unsigned char* data, int width, int height) {
+    std::vector<float> pixels(width * height);
+    int blocksX = (width + 3) / 4;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const unsigned char* block = data + ((y / 4) * blocksX + x / 4) * 8;
+            float red0 = block[0], red1 = block[1];
+
+            float palette[8] = { red0, red1 };
+            if (red0 > red1) {
+                for (int i = 2; i < 8; i++) palette[i] = ((8 - i) * red0 + (i - 1) * red1) / 7.0f;
+            } else {
+                for (int i = 2; i < 6; i++) palette[i] = ((6 - i) * red0 + (i - 1) * red1) / 5.0f;
+                palette[6] = 0.0f;
+                palette[7] = 255.0f;
+            }
+
+            unsigned long long indices = 0;
+            for (int i = 0; i < 6; i++) indices |= (unsigned long long)block[2 + i] << (8 * i);
+
+            int texel = (y % 4) * 4 + x % 4;
+            pixels[y * width + x] = palette[(indices >> (3 * texel)) & 7];
+        }
+    }
+
+    return pixels;
+}
+
+// Compresses a copy of pixels, checks the layout and returns the decoded values
+std::vector<float> RoundTrip(const std::vector<unsigned char>& pixels, int width, int height) {
+    Image image = { 0 };
+    image.data = malloc(pixels.size());
+    memcpy(image.data, pixels.data(), pixels.size());
+    image.width = width;
+    image.height = height;
+    image.mipmaps = 1;
+    image.format = PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+
+    CHECK(ImageCompressRGTC1(&image));
+    CHECK_EQ(image.format, (int)PIXELFORMAT_COMPRESSED_RGTC1_R);
+    CHECK_EQ(rlGetPixelDataSize(width, height, PIXELFORMAT_COMPRESSED_RGTC1_R), ((width + 3) / 4) * ((height + 3) / 4) * 8);
+
+    std::vector<float> decoded = DecodeRGTC1((const unsigned char*)image.data, width, height);
+    free(image.data);
+
+    return decoded;
+}
+
+// Largest error allowed in the 4x4 block of pixel (x, y): half a palette step, 7 steps between the block
+// extremes or 5 between the other values when the block also holds exact 0 and 255, plus rounding
+float BlockErrorBound(const std::vector<unsigned char>& pixels, int width, int height, int x, int y) {
+    int minValue = 255, maxValue = 0;
+
+    for (int by = y & ~3; (by < (y & ~3) + 4) && (by < height); by++) {
+        for (int bx = x & ~3; (bx < (x & ~3) + 4) && (bx < width); bx++) {
+            int value = pixels[by * width + bx];
+            minValue = (value < minValue) ? value : minValue;
+            maxValue = (value > maxValue) ? value : maxValue;
+        }
+    }
+
+    return (float)(maxValue - minValue) / 10.0f + 1.0f;
+}
+
+void TestFlatBlocks() {
+    const unsigned char values[] = { 0, 1, 127, 128, 254, 255 };
+
+    for (unsigned char value : values) {
+        std::vector<unsigned char> pixels(8 * 8, value);
+        std::vector<float> decoded = RoundTrip(pixels, 8, 8);
+
+        for (float texel : decoded) CHECK_EQ(texel, (float)value);
+    }
+
+    // Saturated outside and inside of an SDF, both are stored exactly
+    std::vector<unsigned char> pixels(4 * 4);
+    for (int i = 0; i < 16; i++) pixels[i] = (i % 3 == 0) ? 255 : 0;
+    std::vector<float> decoded = RoundTrip(pixels, 4, 4);
+    for (int i = 0; i < 16; i++) CHECK_EQ(decoded[i], (float)pixels[i]);
+}
+
+void TestErrorBounds(const std::vector<unsigned char>& pixels, int width, int height) {
+    std::vector<float> decoded = RoundTrip(pixels, width, height);
+    double squaredError = 0.0;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            float error = fabsf(decoded[y * width + x] - (float)pixels[y * width + x]);
+            CHECK(error <= BlockErrorBound(pixels, width, height, x, y));
+            squaredError += error * error;
+        }
+    }
+
+    // 8 levels per block keep gradients and SDF ramps within a few levels on average
+    CHECK(sqrt(squaredError / (width * height)) <= 3.0);
+}
+
+void TestGradients() {
+    // Horizontal ramp over the whole range, partial blocks on the right and bottom borders
+    const int width = 61, height = 7;
+    std::vector<unsigned char> pixels(width * height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) pixels[y * width + x] = (unsigned char)(x * 255 / (width - 1));
+    }
+    TestErrorBounds(pixels, width, height);
+
+    // Radial distance field, saturated away from the circle edge like an SDF glyph
+    const int size = 48;
+    std::vector<unsigned char> field(size * size);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            float distance = 16.0f - sqrtf((float)((x - 24) * (x - 24) + (y - 24) * (y - 24)));
+            float value = FONT_SDF_ON_EDGE_VALUE + distance * FONT_SDF_PIXEL_DIST_SCALE / 4.0f;
+            field[y * size + x] = (unsigned char)((value < 0.0f) ? 0.0f : (value > 255.0f) ? 255.0f : value);
+        }
+    }
+    TestErrorBounds(field, size, size);
+}
+
+void TestNoise() {
+    std::mt19937 random(42);
+    const int width = 32, height = 32;
+    std::vector<unsigned char> pixels(width * height);
+
+    for (int iteration = 0; iteration < 20; iteration++) {
+        int low = random() % 256;
+        int range = random() % (256 - low);
+        for (unsigned char& pixel : pixels) pixel = (unsigned char)(low + ((range > 0) ? random() % (range + 1) : 0));
+
+        // Noise spreads values over the block range, only the per texel bound holds
+        std::vector<float> decoded = RoundTrip(pixels, width, height);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                CHECK(fabsf(decoded[y * width + x] - (float)pixels[y * width + x]) <= BlockErrorBound(pixels, width, height, x, y));
+            }
+        }
+    }
+}
+
+void TestInvalidImages() {
+    Image empty = { 0 };
+    CHECK(!ImageCompressRGTC1(&empty));
+    CHECK(!ImageCompressRGTC1(NULL));
+
+    unsigned char pixels[16 * 2] = { 0 };
+    Image grayAlpha = { 0 };
+    grayAlpha.data = pixels;
+    grayAlpha.width = 4;
+    grayAlpha.height = 4;
+    grayAlpha.mipmaps = 1;
+    grayAlpha.format = PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA;
+    CHECK(!ImageCompressRGTC1(&grayAlpha));
+    CHECK(grayAlpha.data == pixels);
+}
+
+}  // namespace
+
+int main() {
+    TestFlatBlocks();
+    TestGradients();
+    TestNoise();
+    TestInvalidImages();
+
+    return CheckFailures();
+}
@@ -0,0 +1,134 @@
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+//
+#include "Check.hpp"
+#include "ShaderPreprocessor.hpp"
+
+namespace {
+
+// Shader files of the tests, written to a scratch directory. Every test uses its own files, variants are cached by path
+const std::filesystem::path TEST_DIR = std::filesystem::temp_directory_path() / "graphics_shader_preprocessor_test";
+
+std::string WriteShader(const std::string& name, const std::string& source) {
+    std::filesystem::path path = TEST_DIR / name;
+    std::filesystem::create_directories(path.parent_path());
+
+    std::ofstream file(path, std::ios::binary);
+    file << source;
+
+    return path.string();
+}
+
+bool Throws(const std::string& path) {
+    try {
+        PreprocessShader(path);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+
+    return false;
+}
+
+size_t Count(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) count++;
+
+    return count;
+}
+
+void TestIncludesAndDefines() {
+    std::string path = WriteShader("main.frag",
+                                   "#version 330\n"
+                                   "#include \"lib/a.glsl\"\n"
+                                   "#include \"lib/b.glsl\"\n"
+                                   "void main() {}\n");
+    WriteShader("lib/a.glsl",
+                "#include \"b.glsl\"\n"
+                "float a;\n");
+    WriteShader("lib/b.glsl",
+                "#version 330\n"
+                "float b;\n");
+
+    const std::string& source = PreprocessShader(path, { { "MSDF", "" }, { "SAMPLES", "4" } });
+
+    // Defines follow #version, includes are relative to the including file and expanded once,
+    // #line keeps the line of every source string (0 the shader, 1.. the includes in order)
+    const std::string expected =
+        "#version 330\n"
+        "#define MSDF\n"
+        "#define SAMPLES 4\n"
+        "#line 2 0\n"
+        "#line 1 1\n"
+        "#line 1 2\n"
+        "\n"  // #version of an included file
+        "float b;\n"
+        "#line 2 1\n"
+        "float a;\n"
+        "#line 3 0\n"
+        "\n"  // b.glsl, already included
+        "void main() {}\n";
+    CHECK_EQ(source, expected);
+
+    // Variants are cached, other defines give another variant
+    CHECK(&PreprocessShader(path, { { "SAMPLES", "4" }, { "MSDF", "" } }) == &source);
+    const std::string& plain = PreprocessShader(path);
+    CHECK(&plain != &source);
+    CHECK_EQ(plain.find("#define"), std::string::npos);
+    CHECK_EQ(Count(plain, "float b;"), (size_t)1);
+}
+
+void TestWithoutVersion() {
+    std::string path = WriteShader("legacy.frag", "void main() {}\n");
+
+    CHECK_EQ(PreprocessShader(path, { { "LEGACY", "1" } }), std::string("#define LEGACY 1\n#line 1 0\nvoid main() {}\n"));
+    CHECK_EQ(PreprocessShader(path), std::string("void main() {}\n"));
+}
+
+void TestErrors() {
+    // Recursive includes, directly and through another file
+    CHECK(Throws(WriteShader("self.frag", "#version 330\n#include \"self.frag\"\n")));
+    WriteShader("cycle/a.glsl", "#include \"b.glsl\"\n");
+    WriteShader("cycle/b.glsl", "#include \"a.glsl\"\n");
+    CHECK(Throws(WriteShader("cycle.frag", "#version 330\n#include \"cycle/a.glsl\"\n")));
+
+    CHECK(Throws(WriteShader("malformed.frag", "#version 330\n#include <glyph.glsl>\n")));
+    CHECK(Throws(WriteShader("missing_include.frag", "#version 330\n#include \"missing.glsl\"\n")));
+    CHECK(Throws((TEST_DIR / "missing.frag").string()));
+
+    // A failed variant is not cached, the fixed file is read again
+    std::string path = WriteShader("fixed.frag", "#version 330\n#include \"fixed.glsl\"\n");
+    CHECK(Throws(path));
+    WriteShader("fixed.glsl", "float fixed;\n");
+    CHECK(!Throws(path));
+}
+
+void TestShippedShaders() {
+    // Every file of assets/shaders expands, none of their includes is recursive
+    for (const auto& entry : std::filesystem::directory_iterator(GRAPHICS_TEST_ASSETS "/shaders")) {
+        if (entry.is_regular_file()) CHECK(!Throws(entry.path().string()));
+    }
+
+    // Variant defines come right after the #version of sdf.frag, include/glyph.glsl is expanded
+    const std::string& source = PreprocessShader(GRAPHICS_TEST_ASSETS "/shaders/sdf.frag", { { "VERTEX_COLOR", "" } });
+    CHECK_EQ(source.rfind("#version 330\n#define VERTEX_COLOR\n#line ", 0), (size_t)0);
+    CHECK_EQ(source.find("#include"), std::string::npos);
+    CHECK(source.find("glyphCoverage") != std::string::npos);
+}
+
+}  // namespace
+
+int main() {
+    std::filesystem::remove_all(TEST_DIR);
+
+    TestIncludesAndDefines();
+    TestWithoutVersion();
+    TestErrors();
+    TestShippedShaders();
+
+    std::filesystem::remove_all(TEST_DIR);
+
+    return CheckFailures();
+}
@@ -0,0 +1,138 @@
+#include <string>
+#include <vector>
+
+//
+#include "Check.hpp"
+#include "Label/TextLayout.hpp"
+
+namespace {
+
+// Font of 'a'-'z' and '?', advance of glyph i is i + 1 pixels. 'z' has no advance, its width is used
+struct TestFont {
+    std::vector<GlyphInfo> glyphs;
+    std::vector<Rectangle> recs;
+    Font font = { 0 };
+    int lookups = 0;  // Calls to the glyph index function, only made when a layout is built
+
+    TestFont() {
+        for (int i = 0; i < 27; i++) {
+            GlyphInfo glyph = { 0 };
+            glyph.value = (i < 26) ? 'a' + i : '?';
+            glyph.advanceX = (glyph.value == 'z') ? 0 : i + 1;
+            glyphs.push_back(glyph);
+            recs.push_back({ 0.0f, 0.0f, 40.0f, 10.0f });
+        }
+
+        font.baseSize = 10;
+        font.glyphCount = (int)glyphs.size();
+        font.glyphs = glyphs.data();
+        font.recs = recs.data();
+    }
+
+    const TextLayout& get(TextLayoutCache& cache, const char* text) {
+        return cache.get(text, font, [this](int codepoint) {
+            lookups++;
+            return ((codepoint >= 'a') && (codepoint <= 'z')) ? codepoint - 'a' : 26;
+        });
+    }
+};
+
+void TestLayout() {
+    TestFont font;
+    TextLayoutCache cache;
+
+    const KerningPair pairs[] = { { 'a', 'b', -0.5f }, { 'b', 'a', 2.0f } };
+    cache.kerning.add(pairs, 2);
+
+    const TextLayout& layout = font.get(cache, "ab a\nbaz");
+    CHECK_EQ(layout.lineCount, 2);
+    CHECK_EQ(layout.glyphs.size(), (size_t)6);
+    CHECK_EQ(layout.maxLineCodepoints, 4);
+
+    // a(1) kern(-0.5) b(2) space(advance of '?', 27) a
+    CHECK_EQ(layout.glyphs[1].penX, 0.5f);
+    CHECK_EQ(layout.glyphs[2].codepoint, 'a');
+    CHECK_EQ(layout.glyphs[2].penX, 29.5f);
+    CHECK_EQ(layout.glyphs[2].column, 3);
+
+    // Kerning is reset at the line start: b(2) kern(2) a(1) z(width 40)
+    CHECK_EQ(layout.glyphs[3].line, 1);
+    CHECK_EQ(layout.glyphs[3].penX, 0.0f);
+    CHECK_EQ(layout.glyphs[4].penX, 4.0f);
+    CHECK_EQ(layout.glyphs[5].penX, 5.0f);
+    CHECK_EQ(layout.maxLineAdvance, 45.0f);
+
+    CHECK_EQ(cache.kerning.get('a', 'b'), -0.5f);
+    CHECK_EQ(cache.kerning.get('a', 'c'), 0.0f);
+}
+
+void TestHitsAndEvictions() {
+    TestFont font;
+    TextLayoutCache cache(2);
+
+    const TextLayout* first = &font.get(cache, "abc");
+    CHECK_EQ(font.lookups, 3);
+    CHECK_EQ(cache.size(), (size_t)1);
+
+    // A hit returns the same layout without laying the text out again
+    CHECK(&font.get(cache, "abc") == first);
+    CHECK_EQ(font.lookups, 3);
+
+    font.get(cache, "de");
+    CHECK_EQ(font.lookups, 5);
+    CHECK_EQ(cache.size(), (size_t)2);
+
+    // "abc" was used last, the third text evicts "de"
+    CHECK(&font.get(cache, "abc") == first);
+    font.get(cache, "f");
+    CHECK_EQ(font.lookups, 6);
+    CHECK_EQ(cache.size(), (size_t)2);
+
+    CHECK(&font.get(cache, "abc") == first);
+    CHECK_EQ(font.lookups, 6);
+    font.get(cache, "de");
+    CHECK_EQ(font.lookups, 8);
+    CHECK_EQ(cache.size(), (size_t)2);
+
+    // "f" was evicted by "de", "abc" is still there
+    font.get(cache, "abc");
+    CHECK_EQ(font.lookups, 8);
+    font.get(cache, "f");
+    CHECK_EQ(font.lookups, 9);
+
+    // Kerning changes require invalidate(), every text is laid out again
+    cache.invalidate();
+    CHECK_EQ(cache.size(), (size_t)0);
+    const KerningPair pair = { 'a', 'b', 1.0f };
+    cache.kerning.add(&pair, 1);
+    CHECK_EQ(font.get(cache, "abc").glyphs[1].penX, 2.0f);
+    CHECK_EQ(font.lookups, 12);
+
+    // NULL is the empty text
+    CHECK(font.get(cache, NULL).glyphs.empty());
+    CHECK(&font.get(cache, "") == &font.get(cache, NULL));
+}
+
+void TestZeroCapacity() {
+    TestFont font;
+    TextLayoutCache cache(0);
+
+    // Capacity is at least one, the last layout stays valid
+    font.get(cache, "ab");
+    font.get(cache, "ab");
+    CHECK_EQ(font.lookups, 2);
+    CHECK_EQ(cache.size(), (size_t)1);
+
+    font.get(cache, "c");
+    CHECK_EQ(cache.size(), (size_t)1);
+}
+
+}  // namespace
+
+int main() {
+    TestLayout();
+    TestHitsAndEvictions();
+    TestZeroCapacity();
+
+    return CheckFailures();
+}
@@ -0,0 +1,211 @@
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+//
+#include "Check.hpp"
+#include "Label/Utf8.hpp"
+
+// Built twice: with the kernel picked at runtime (AVX2 or SSE2 on x86) and with UTF8_SCALAR_ONLY,
+// both builds must match the same byte by byte reference decoder
+
+namespace {
+
+// Well formed byte sequences of the Unicode standard (table 3-7), every other byte decodes to '?'
+size_t ReferenceSequence(const unsigned char* src, size_t length, int* codepoint) {
+    unsigned char lead = src[0];
+    size_t size = 0;
+    unsigned char secondMin = 0x80, secondMax = 0xbf;
+
+    if ((lead >= 0xc2) && (lead <= 0xdf)) {
+        size = 2;
+    } else if ((lead >= 0xe0) && (lead <= 0xef)) {
+        size = 3;
+        if (lead == 0xe0) secondMin = 0xa0;
+        if (lead == 0xed) secondMax = 0x9f;
+    } else if ((lead >= 0xf0) && (lead <= 0xf4)) {
+        size = 4;
+        if (lead == 0xf0) secondMin = 0x90;
+        if (lead == 0xf4) secondMax = 0x8f;
+    } else {
+        return 0;
+    }
+
+    if (size > length) return 0;
+    if ((src[1] < secondMin) || (src[1] > secondMax)) return 0;
+    for (size_t i = 2; i < size; i++) {
+        if ((src[i] < 0x80) || (src[i] > 0xbf)) return 0;
+    }
+
+    int value = lead & (0xff >> (size + 1));
+    for (size_t i = 1; i < size; i++) value = (value << 6) | (src[i] & 0x3f);
+
+    *codepoint = value;
+    return size;
+}
+
+size_t ReferenceDecode(const std::string& text, std::vector<int>& codepoints) {
+    const unsigned char* src = (const unsigned char*)text.data();
+    size_t invalidBytes = 0;
+
+    for (size_t i = 0; i < text.size();) {
+        int codepoint = src[i];
+        size_t size = 1;
+
+        if (src[i] >= 0x80) {
+            size = ReferenceSequence(src + i, text.size() - i, &codepoint);
+            if (size == 0) {
+                codepoint = '?';
+                size = 1;
+                invalidBytes++;
+            }
+        }
+
+        codepoints.push_back(codepoint);
+        i += size;
+    }
+
+    return invalidBytes;
+}
+
+size_t ReferenceLeadBytes(const std::string& text) {
+    size_t count = 0;
+    for (unsigned char byte : text) count += ((byte & 0xc0) != 0x80) ? 1 : 0;
+
+    return count;
+}
+
+// Decodes text with the library and the reference, also with text at every offset of a SIMD block
+void CheckText(const std::string& text) {
+    for (size_t shift = 0; shift < 33; shift += 11) {
+        std::string shifted = std::string(shift, 'a') + text;
+
+        std::vector<int> expected = { -7 };
+        size_t expectedInvalid = ReferenceDecode(shifted, expected);
+
+        // Codepoints are appended, the first value must be kept
+        std::vector<int> decoded = { -7 };
+        size_t invalid = DecodeUtf8(shifted.data(), shifted.size(), decoded);
+
+        CHECK_EQ(invalid, expectedInvalid);
+        CHECK(decoded == expected);
+        CHECK_EQ(ValidateUtf8(shifted.data(), shifted.size()), expectedInvalid == 0);
+        CHECK_EQ(CountUtf8Codepoints(shifted.data(), shifted.size()), ReferenceLeadBytes(shifted));
+    }
+}
+
+void TestKernel() {
+#ifdef UTF8_SCALAR_ONLY
+    CHECK_EQ(std::string(GetUtf8KernelName()), std::string("scalar"));
+#elif defined(__x86_64__) || defined(_M_X64)
+    CHECK(std::string(GetUtf8KernelName()) != "scalar");
+#endif
+}
+
+void TestWellFormed() {
+    std::string text = "Hello, world! ";
+    text += "\xc3\xa9\xce\xb1\xd0\x96";          // 2 bytes: e acute, alpha, zhe
+    text += "\xe4\xb8\xad\xe6\x96\x87\xef\xbf\xbd";  // 3 bytes: CJK, U+FFFD
+    text += "\xf0\x9f\x98\x80\xf4\x8f\xbf\xbf";      // 4 bytes: emoji, U+10FFFF
+    text += std::string(100, 'x') + "\xc2\x80" + std::string(31, 'y');
+
+    std::vector<int> decoded;
+    CHECK_EQ(DecodeUtf8(text.data(), text.size(), decoded), (size_t)0);
+    CHECK_EQ(decoded[14], 0xe9);
+    CHECK_EQ(decoded[17], 0x4e2d);
+    CHECK_EQ(decoded[19], 0xfffd);
+    CHECK_EQ(decoded[20], 0x1f600);
+    CHECK_EQ(decoded[21], 0x10ffff);
+    CHECK(ValidateUtf8(text.data(), text.size()));
+
+    CheckText(text);
+    CheckText("");
+    CheckText(std::string(200, 'A'));
+}
+
+void TestInvalid() {
+    const char* cases[] = {
+        "\x80",                  // Continuation byte without a lead
+        "\xbf\x80\x80",          //
+        "\xc0\xaf",              // Overlong '/'
+        "\xc1\xbf",              // Overlong 2 bytes
+        "\xe0\x80\xaf",          // Overlong 3 bytes
+        "\xe0\x9f\xbf",          //
+        "\xf0\x80\x80\xaf",      // Overlong 4 bytes
+        "\xf0\x8f\xbf\xbf",      //
+        "\xed\xa0\x80",          // Surrogates
+        "\xed\xbf\xbf",          //
+        "\xf4\x90\x80\x80",      // Above U+10FFFF
+        "\xf5\x80\x80\x80",      //
+        "\xf8\x88\x80\x80\x80",  // 5 and 6 byte forms
+        "\xfc\x84\x80\x80\x80\x80",
+        "\xfe\xff",
+        "\xc3\x28",              // Bad continuation byte
+        "\xe2\x28\xa1",          //
+        "\xf0\x9f\x28\x80",      //
+    };
+
+    for (const char* bytes : cases) {
+        std::string text = std::string(40, 'a') + bytes + std::string(40, 'b');
+        std::vector<int> decoded;
+
+        CHECK(DecodeUtf8(text.data(), text.size(), decoded) > 0);
+        CHECK(!ValidateUtf8(text.data(), text.size()));
+        CheckText(text);
+    }
+
+    // Every invalid byte is decoded as '?' on its own, decoding resumes on the next byte
+    std::vector<int> decoded;
+    CHECK_EQ(DecodeUtf8("\xc0\xafz", 3, decoded), (size_t)2);
+    CHECK(decoded == std::vector<int>({ '?', '?', 'z' }));
+}
+
+void TestTruncated() {
+    const std::string sequences[] = { "\xc3\xa9", "\xe4\xb8\xad", "\xf0\x9f\x98\x80" };
+
+    for (const std::string& sequence : sequences) {
+        for (size_t size = 1; size < sequence.size(); size++) {
+            // At the end of the text, and followed by ASCII
+            CheckText(std::string(64, 'a') + sequence.substr(0, size));
+            CheckText(std::string(64, 'a') + sequence.substr(0, size) + std::string(64, 'b'));
+
+            std::vector<int> decoded;
+            std::string text = sequence.substr(0, size);
+            CHECK_EQ(DecodeUtf8(text.data(), text.size(), decoded), size);
+        }
+    }
+}
+
+void TestRandom() {
+    std::mt19937 random(1234);
+    const char* pieces[] = { "\xc3\xa9", "\xe4\xb8\xad", "\xf0\x9f\x98\x80", "\xed\xa0\x80", "\xc0\xaf", "\x80", "\xff", "\xe4\xb8", "\xf4\x90\x80\x80" };
+
+    for (int iteration = 0; iteration < 500; iteration++) {
+        std::string text;
+        int pieceCount = random() % 12;
+
+        for (int i = 0; i < pieceCount; i++) {
+            text += std::string(random() % 70, (char)('a' + random() % 26));
+            if (random() % 4 == 0) {
+                text += (char)(random() % 256);
+            } else {
+                text += pieces[random() % (sizeof(pieces) / sizeof(pieces[0]))];
+            }
+        }
+
+        CheckText(text);
+    }
+}
+
+}  // namespace
+
+int main() {
+    TestKernel();
+    TestWellFormed();
+    TestInvalid();
+    TestTruncated();
+    TestRandom();
+
+    return CheckFailures();
+}